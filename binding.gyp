@@ -20,6 +20,15 @@
         "src/addon/file-wrap/file-wrap.h",
         "src/addon/file-wrap/file-wrap.cc",
         
+        "src/addon/bit-wrap/bit-wrap.h",
+        "src/addon/bit-wrap/bit-wrap.cc",
+
+        "src/addon/block-cache/block-cache.h",
+        "src/addon/block-cache/block-cache.cc",
+
+        "src/addon/read-many/read-many.h",
+        "src/addon/read-many/read-many.cc",
+
         "src/addon/utils/utils.h",
         "src/addon/utils/utils.cc",
 
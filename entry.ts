@@ -1,5 +1,7 @@
 export { BinaryReader } from './src/binary-reader';
 export { BinaryWriter } from './src/binary-writer';
-export { File, IFile, NativeFile } from './src/addon/file';
+export { File, IFile, INativeFile, NativeFile, ReadExtent, setReadManyQueueDepth } from './src/addon/file';
 export { IEncoding, IEncoder, IDecoder } from './src/encoding';
-export { SeekOrigin } from './src/constants/mode';
\ No newline at end of file
+export { setBlockCache, cacheStats, CacheStats } from './src/addon/block-cache';
+export { BitReader, BitWriter, IBitReader, IBitWriter, IntegerArray } from './src/addon/bits';
+export { SeekOrigin, BitOrder } from './src/constants/mode';
\ No newline at end of file
@@ -0,0 +1,386 @@
+#include "bit-wrap.h"
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+#include <napi.h>
+#include <uv.h>
+#include "../utils/utils.h"
+#include "../exception-handler/exception-handler.h"
+
+namespace BitWrap {
+   void Prepare(Napi::Env env, Napi::Object exports) {
+      BitReader::Init(env, exports);
+      BitWriter::Init(env, exports);
+   }
+
+   static FileWrap::File *GetFileArg(const Napi::CallbackInfo &info) {
+      auto *file = FileWrap::File::FromValue(info.Env(), info[0]);
+      if (file == NULL) // file
+         throw NodeException(NodeError::Type, "Must provide a NativeFile instance as the first argument.");
+      return file;
+   }
+
+   static BitOrder GetOrderArg(Napi::Value value) {
+      if (IsNullOrUndefined(value))
+         return BitOrder::MsbFirst;
+      if (!value.IsNumber()) // order
+         throw NodeException(NodeError::Type, "Must provide a BitOrder value as the second argument.");
+      auto order = value.As<Napi::Number>().Int32Value();
+      if (order != (int)BitOrder::MsbFirst && order != (int)BitOrder::LsbFirst)
+         throw NodeException(NodeError::Range, "Invalid BitOrder value.");
+      return (BitOrder)order;
+   }
+
+   static unsigned GetBitCountArg(Napi::Value value, const char *argIdx, unsigned max) {
+      if (IsSafeInteger(value, sizeof(int)) != IntegerInvalid::None)
+         throw NodeException(NodeError::Type, std::string("Must provide an integer bit count as the ") + argIdx + ".");
+      auto n = value.As<Napi::Number>().Int32Value();
+      if (n < 1 || (unsigned)n > max)
+         throw NodeException(NodeError::Range, "Bit count must be between 1 and " + std::to_string(max) + ".");
+      return (unsigned)n;
+   }
+
+   // Validates (array, width, offset?, count?) arguments of unpack and pack.
+   struct TypedArrayArgs {
+      uint8_t *data;
+      napi_typedarray_type type;
+      size_t offset;
+      size_t count;
+      unsigned width;
+   };
+   static TypedArrayArgs GetTypedArrayArgs(const Napi::CallbackInfo &info) {
+      if (!info[0].IsTypedArray()) // array
+         throw NodeException(NodeError::Type, "Must provide an integer TypedArray as the first argument.");
+      auto array = info[0].As<Napi::TypedArray>();
+      auto type = array.TypedArrayType();
+      if (type != napi_int8_array && type != napi_uint8_array && type != napi_uint8_clamped_array &&
+         type != napi_int16_array && type != napi_uint16_array && type != napi_int32_array && type != napi_uint32_array)
+         throw NodeException(NodeError::Type, "Must provide an integer TypedArray as the first argument.");
+
+      auto width = GetBitCountArg(info[1], "second argument", (unsigned)array.ElementSize() * 8); // width
+
+      if (!IsNullOrUndefined(info[2])) {
+         auto inputError = IsSafeInteger(info[2], sizeof(size_t), true);
+         if (inputError == IntegerInvalid::Type) // offset
+            throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(size_t), "third argument", true));
+         else if (inputError == IntegerInvalid::Range) // offset
+            throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), "third argument", true));
+      }
+      if (!IsNullOrUndefined(info[3])) {
+         auto inputError = IsSafeInteger(info[3], sizeof(size_t), true);
+         if (inputError == IntegerInvalid::Type) // count
+            throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(size_t), "fourth argument", true));
+         if (inputError == IntegerInvalid::Range) // count
+            throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), "fourth argument", true));
+      }
+
+      auto length = array.ElementLength();
+      auto offset = (size_t)TRY_GET_NUMBER(info[2], 0);
+      if (offset > length)
+         throw NodeException(NodeError::Range, "offset is not allowed to be greater than array's length.");
+      auto count = (size_t)TRY_GET_NUMBER(info[3], length - offset);
+      if (length - offset < count)
+         throw NodeException(NodeError::Range, "Your requested range would cause array overflow.");
+
+      auto data = (uint8_t *)array.ArrayBuffer().Data() + array.ByteOffset() + offset * array.ElementSize();
+      return { data, type, offset, count, width };
+   }
+
+   static NodeException EndOfFileException() {
+      return CSException(NodeError::Range, "ReadBeyondEndOfFile", "Read beyond end-of-file.");
+   }
+
+   void BitReader::Init(Napi::Env env, Napi::Object exports) {
+      auto func = DefineClass(env, "BitReader",
+         {
+            // Getters
+            InstanceAccessor<&BitReader::getFile>("file"),
+            InstanceAccessor<&BitReader::getOrder>("order"),
+            // Methods
+            InstanceMethod<&BitReader::peek>("peek"),
+            InstanceMethod<&BitReader::read>("read"),
+            InstanceMethod<&BitReader::skip>("skip"),
+            InstanceMethod<&BitReader::alignToByte>("alignToByte"),
+            InstanceMethod<&BitReader::unpack>("unpack"),
+            InstanceMethod<&BitReader::sync>("sync")
+         }
+      );
+      exports.Set("BitReader", func);
+   }
+   // new (file: IFile, order?: BitOrder) => BitReader
+   BitReader::BitReader(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<BitReader>(info), file(NULL), order(BitOrder::MsbFirst) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto *file = GetFileArg(info);
+         auto order = GetOrderArg(info[1]);
+         if (!file->GetState().canRead)
+            throw CSException(NodeError::Reference, "FileNotReadable", "Input file is not readable.");
+         this->fileRef = Napi::Persistent(info[0].As<Napi::Object>());
+         this->file = file;
+         this->order = order;
+      });
+   }
+   void BitReader::Refill() {
+      if (this->bitCount > 56) return;
+      uint8_t bytes[8];
+      auto nRead = this->file->Read(bytes, (64 - this->bitCount) / 8);
+      for (size_t i = 0; i < nRead; i++) {
+         if (this->order == BitOrder::MsbFirst)
+            this->bitBuf |= (uint64_t)bytes[i] << (56 - this->bitCount);
+         else
+            this->bitBuf |= (uint64_t)bytes[i] << this->bitCount;
+         this->bitCount += 8;
+      }
+   }
+   template <typename T>
+   size_t BitReader::Unpack(T *out, size_t count, unsigned width) {
+      size_t i = 0;
+      for (; i < count; i++) {
+         if (this->bitCount < width) {
+            Refill();
+            if (this->bitCount < width) break;
+         }
+         out[i] = (T)Peek(width);
+         Consume(width);
+      }
+      return i;
+   }
+   // peek(bits: number): number
+   Napi::Value BitReader::peek(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      Napi::Value rs;
+      HandleException(env, [&]() {
+         auto n = GetBitCountArg(info[0], "first argument", MAX_BITS_PER_CALL); // bits
+         if (this->bitCount < n)
+            Refill();
+         // missing bits past the end of file are read as zero, as the register is zero-filled
+         rs = Napi::Number::New(env, (double)Peek(n));
+      });
+      return rs;
+   }
+   // read(bits: number): number
+   Napi::Value BitReader::read(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      Napi::Value rs;
+      HandleException(env, [&]() {
+         auto n = GetBitCountArg(info[0], "first argument", MAX_BITS_PER_CALL); // bits
+         if (this->bitCount < n) {
+            Refill();
+            if (this->bitCount < n)
+               throw EndOfFileException();
+         }
+         auto value = Peek(n);
+         Consume(n);
+         rs = Napi::Number::New(env, (double)value);
+      });
+      return rs;
+   }
+   // skip(bits: number): void
+   void BitReader::skip(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto inputError = IsSafeInteger(info[0], sizeof(size_t), true);
+         if (inputError == IntegerInvalid::Type) // bits
+            throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(size_t), "first argument", true));
+         else if (inputError == IntegerInvalid::Range) // bits
+            throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), "first argument", true));
+
+         auto n = (uint64_t)info[0].As<Napi::Number>().DoubleValue();
+         if (this->bitCount < n)
+            Refill();
+         if (n <= this->bitCount) {
+            // never shift the register by 64, that's undefined behavior
+            while (n > 0) {
+               auto take = n < 56 ? (unsigned)n : 56;
+               Consume(take);
+               n -= take;
+            }
+            return;
+         }
+         // the register holds every bit up to the current position of the file
+         auto bytes = (n - this->bitCount) / 8;
+         auto bits = (unsigned)((n - this->bitCount) % 8);
+         if (this->file->GetState().canSeek) {
+            // jump over the whole bytes, after making sure that the file is long enough
+            auto pos = this->file->Tell();
+            if ((uint64_t)pos + bytes + (bits != 0 ? 1 : 0) > (uint64_t)this->file->Size())
+               throw EndOfFileException();
+            auto target = pos + (int64_t)bytes;
+            if (target > LONG_MAX)
+               THROW_ERRNO_EX(EOVERFLOW, "");
+            this->bitBuf = 0;
+            this->bitCount = 0;
+            this->file->Seek((long)target, SEEK_SET);
+         } else {
+            // a pipe can only be read through, so hitting EOF here leaves the reader at the end
+            this->bitBuf = 0;
+            this->bitCount = 0;
+            char scratch[4096];
+            while (bytes > 0) {
+               auto nRead = this->file->Read(scratch, bytes < sizeof(scratch) ? (size_t)bytes : sizeof(scratch));
+               if (nRead == 0)
+                  throw EndOfFileException();
+               bytes -= nRead;
+            }
+         }
+         if (bits != 0) {
+            Refill();
+            if (this->bitCount < bits)
+               throw EndOfFileException();
+            Consume(bits);
+         }
+      });
+   }
+   // alignToByte(): void
+   void BitReader::alignToByte(const Napi::CallbackInfo &info) {
+      Consume(this->bitCount % 8);
+   }
+   // unpack(array: TypedArray, bits: number, offset?: number, count?: number): number
+   Napi::Value BitReader::unpack(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      Napi::Value rs;
+      HandleException(env, [&]() {
+         auto args = GetTypedArrayArgs(info);
+         size_t nRead = 0;
+         switch (args.type) {
+            case napi_int8_array:
+               nRead = Unpack((int8_t *)args.data, args.count, args.width); break;
+            case napi_uint8_array:
+            case napi_uint8_clamped_array:
+               nRead = Unpack((uint8_t *)args.data, args.count, args.width); break;
+            case napi_int16_array:
+               nRead = Unpack((int16_t *)args.data, args.count, args.width); break;
+            case napi_uint16_array:
+               nRead = Unpack((uint16_t *)args.data, args.count, args.width); break;
+            case napi_int32_array:
+               nRead = Unpack((int32_t *)args.data, args.count, args.width); break;
+            case napi_uint32_array:
+               nRead = Unpack((uint32_t *)args.data, args.count, args.width); break;
+            default:
+               break;
+         }
+         rs = Napi::Number::New(env, (double)nRead);
+      });
+      return rs;
+   }
+   // sync(): void
+   void BitReader::sync(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         Consume(this->bitCount % 8);
+         if (this->bitCount > 0)
+            this->file->Seek(-(long)(this->bitCount / 8), SEEK_CUR);
+         this->bitBuf = 0;
+         this->bitCount = 0;
+      });
+   }
+
+   void BitWriter::Init(Napi::Env env, Napi::Object exports) {
+      auto func = DefineClass(env, "BitWriter",
+         {
+            // Getters
+            InstanceAccessor<&BitWriter::getFile>("file"),
+            InstanceAccessor<&BitWriter::getOrder>("order"),
+            // Methods
+            InstanceMethod<&BitWriter::write>("write"),
+            InstanceMethod<&BitWriter::alignToByte>("alignToByte"),
+            InstanceMethod<&BitWriter::pack>("pack"),
+            InstanceMethod<&BitWriter::flush>("flush")
+         }
+      );
+      exports.Set("BitWriter", func);
+   }
+   // new (file: IFile, order?: BitOrder) => BitWriter
+   BitWriter::BitWriter(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<BitWriter>(info), file(NULL), order(BitOrder::MsbFirst) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto *file = GetFileArg(info);
+         auto order = GetOrderArg(info[1]);
+         if (!file->GetState().canWrite)
+            throw CSException(NodeError::Reference, "FileNotWritable", "Output file is not writable.");
+         this->fileRef = Napi::Persistent(info[0].As<Napi::Object>());
+         this->file = file;
+         this->order = order;
+      });
+   }
+   void BitWriter::Drain() {
+      auto nBytes = this->bitCount / 8;
+      if (nBytes == 0) return;
+      uint8_t bytes[8];
+      for (unsigned i = 0; i < nBytes; i++) {
+         if (this->order == BitOrder::MsbFirst) {
+            bytes[i] = (uint8_t)(this->bitBuf >> 56);
+            this->bitBuf <<= 8;
+         } else {
+            bytes[i] = (uint8_t)this->bitBuf;
+            this->bitBuf >>= 8;
+         }
+      }
+      this->bitCount -= nBytes * 8;
+      this->file->Write(bytes, nBytes);
+   }
+   template <typename T>
+   void BitWriter::Pack(const T *in, size_t count, unsigned width) {
+      auto mask = (UINT64_C(1) << width) - 1;
+      for (size_t i = 0; i < count; i++)
+         Put((uint64_t)in[i] & mask, width);
+   }
+   // write(value: number, bits: number): void
+   void BitWriter::write(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto inputError = IsSafeInteger(info[0], sizeof(int64_t), true);
+         if (inputError == IntegerInvalid::Type) // value
+            throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(int64_t), "first argument", true));
+         else if (inputError == IntegerInvalid::Range) // value
+            throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(int64_t), "first argument", true));
+
+         auto n = GetBitCountArg(info[1], "second argument", MAX_BITS_PER_CALL); // bits
+         auto value = (uint64_t)info[0].As<Napi::Number>().DoubleValue();
+         if ((value >> n) != 0)
+            throw NodeException(NodeError::Range, "value does not fit in " + std::to_string(n) + " bits.");
+         Put(value, n);
+      });
+   }
+   // alignToByte(): void
+   void BitWriter::alignToByte(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto padding = (8 - this->bitCount % 8) % 8;
+         if (padding != 0)
+            Put(0, padding);
+      });
+   }
+   // pack(array: TypedArray, bits: number, offset?: number, count?: number): void
+   void BitWriter::pack(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto args = GetTypedArrayArgs(info);
+         switch (args.type) {
+            // signed elements are packed as their two's complement low bits
+            case napi_int8_array:
+            case napi_uint8_array:
+            case napi_uint8_clamped_array:
+               Pack((const uint8_t *)args.data, args.count, args.width); break;
+            case napi_int16_array:
+            case napi_uint16_array:
+               Pack((const uint16_t *)args.data, args.count, args.width); break;
+            case napi_int32_array:
+            case napi_uint32_array:
+               Pack((const uint32_t *)args.data, args.count, args.width); break;
+            default:
+               break;
+         }
+      });
+   }
+   // flush(): void
+   void BitWriter::flush(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         Drain();
+         this->file->Flush();
+      });
+   }
+}
@@ -0,0 +1,105 @@
+#ifndef BIT_WRAP_H
+#define BIT_WRAP_H
+
+#include <napi.h>
+#include <uv.h>
+#include <cstdio>
+#include <cstdint>
+#include "../file-wrap/file-wrap.h"
+namespace BitWrap {
+   void Prepare(Napi::Env env, Napi::Object exports);
+
+   // The largest bit count that a JS number can hold exactly.
+   const unsigned MAX_BITS_PER_CALL = 53;
+
+   enum class BitOrder {
+      MsbFirst = 0, LsbFirst = 1
+   };
+
+   // Reads bit fields from a File through a 64-bit register which is refilled
+   // a few bytes at a time, so that it always holds at least 57 bits unless EOF is hit.
+   class BitReader : public Napi::ObjectWrap<BitReader> {
+   public:
+      static void Init(Napi::Env env, Napi::Object exports);
+      BitReader(const Napi::CallbackInfo &info);
+
+   private:
+      Napi::ObjectReference fileRef;
+      FileWrap::File *file;
+      BitOrder order;
+      // MsbFirst: the next bit is the highest bit; LsbFirst: the next bit is the lowest bit.
+      // Bits outside of bitCount are always zero.
+      uint64_t bitBuf = 0;
+      unsigned bitCount = 0;
+
+      void Refill();
+      uint64_t Peek(unsigned n) {
+         if (this->order == BitOrder::MsbFirst)
+            return this->bitBuf >> (64 - n);
+         return this->bitBuf & ((UINT64_C(1) << n) - 1);
+      }
+      void Consume(unsigned n) {
+         if (this->order == BitOrder::MsbFirst)
+            this->bitBuf <<= n;
+         else
+            this->bitBuf >>= n;
+         this->bitCount -= n;
+      }
+      template <typename T>
+      size_t Unpack(T *out, size_t count, unsigned width);
+
+      Napi::Value getOrder(const Napi::CallbackInfo &info) {
+         return Napi::Number::New(info.Env(), (double)this->order);
+      }
+      Napi::Value getFile(const Napi::CallbackInfo &info) {
+         return this->fileRef.Value();
+      }
+      Napi::Value peek(const Napi::CallbackInfo &info);
+      Napi::Value read(const Napi::CallbackInfo &info);
+      void skip(const Napi::CallbackInfo &info);
+      void alignToByte(const Napi::CallbackInfo &info);
+      Napi::Value unpack(const Napi::CallbackInfo &info);
+      void sync(const Napi::CallbackInfo &info);
+   };
+
+   // Writes bit fields to a File through a 64-bit register which is drained whenever it cannot take the next field.
+   class BitWriter : public Napi::ObjectWrap<BitWriter> {
+   public:
+      static void Init(Napi::Env env, Napi::Object exports);
+      BitWriter(const Napi::CallbackInfo &info);
+
+   private:
+      Napi::ObjectReference fileRef;
+      FileWrap::File *file;
+      BitOrder order;
+      // MsbFirst: bits are filled from the highest bit; LsbFirst: bits are filled from the lowest bit.
+      uint64_t bitBuf = 0;
+      unsigned bitCount = 0;
+
+      void Drain();
+      void Put(uint64_t value, unsigned n) {
+         if (this->bitCount + n > 64)
+            Drain();
+         if (this->order == BitOrder::MsbFirst)
+            this->bitBuf |= value << (64 - this->bitCount - n);
+         else
+            this->bitBuf |= value << this->bitCount;
+         this->bitCount += n;
+      }
+      template <typename T>
+      void Pack(const T *in, size_t count, unsigned width);
+
+      Napi::Value getOrder(const Napi::CallbackInfo &info) {
+         return Napi::Number::New(info.Env(), (double)this->order);
+      }
+      Napi::Value getFile(const Napi::CallbackInfo &info) {
+         return this->fileRef.Value();
+      }
+      void write(const Napi::CallbackInfo &info);
+      void alignToByte(const Napi::CallbackInfo &info);
+      void pack(const Napi::CallbackInfo &info);
+      void flush(const Napi::CallbackInfo &info);
+   };
+}
+
+#endif // !BIT_WRAP_H
@@ -0,0 +1,84 @@
+import { NativeBitReader as _NativeBitReader, NativeBitWriter as _NativeBitWriter } from '.';
+import { BitOrder } from '../constants/mode';
+import { INativeFile } from './file';
+
+/** Integer TypedArrays that can be used with unpack and pack. */
+export type IntegerArray = Int8Array | Uint8Array | Uint8ClampedArray | Int16Array | Uint16Array | Int32Array | Uint32Array;
+
+/**
+ * Reads bit fields from a NativeFile, using a 64-bit register that holds at least 57 bits of lookahead.
+ * The reader takes bytes from the file ahead of what has been consumed, call `sync` before using the file directly again.
+ */
+export interface IBitReader {
+  /** The underlying file of the reader. */
+  readonly file: INativeFile;
+  /** The bit order of the reader. */
+  readonly order: BitOrder;
+  /**
+   * Returns the next bits without consuming them. Bits past the end of file are read as zero.
+   * @param bits The number of bits, from 1 to 53.
+   */
+  peek(bits: number): number;
+  /**
+   * Reads and consumes the next bits.
+   * @param bits The number of bits, from 1 to 53.
+   */
+  read(bits: number): number;
+  /**
+   * Consumes the next bits without returning them. On a seekable file, whole bytes are skipped by seeking,
+   * and the reader is left untouched if the file is too short. On a non-seekable file, the reader is left at the end of file in that case.
+   * @param bits The number of bits to skip.
+   */
+  skip(bits: number): void;
+  /** Discards the remaining bits of the current byte. */
+  alignToByte(): void;
+  /**
+   * Reads fixed-width unsigned fields into a TypedArray, stops early if the end of file is reached.
+   * @param array A TypedArray to read fields into.
+   * @param bits The width of each field, from 1 to the bit size of an element.
+   * @param offset The index of the first element to fill.
+   * @param count The number of fields to read.
+   * @returns The number of fields read.
+   */
+  unpack(array: IntegerArray, bits: number, offset?: number, count?: number): number;
+  /**
+   * Aligns the reader to a byte boundary, then moves the position indicator of the file back to the first byte that has not been consumed.
+   * The file must be seekable if any lookahead byte is left.
+   */
+  sync(): void;
+}
+
+/**
+ * Writes bit fields to a NativeFile, using a 64-bit register that is written to the file when it gets full.
+ * Call `alignToByte` and `flush` when you are done, the last incomplete byte is only written after being aligned.
+ */
+export interface IBitWriter {
+  /** The underlying file of the writer. */
+  readonly file: INativeFile;
+  /** The bit order of the writer. */
+  readonly order: BitOrder;
+  /**
+   * Writes a value using the given number of bits.
+   * @param value A non-negative integer that fits in `bits` bits.
+   * @param bits The number of bits, from 1 to 53.
+   */
+  write(value: number, bits: number): void;
+  /** Pads the current byte with zero bits. */
+  alignToByte(): void;
+  /**
+   * Writes the low bits of each element of a TypedArray as fixed-width fields.
+   * @param array A TypedArray containing the fields.
+   * @param bits The width of each field, from 1 to the bit size of an element.
+   * @param offset The index of the first element to write.
+   * @param count The number of fields to write.
+   */
+  pack(array: IntegerArray, bits: number, offset?: number, count?: number): void;
+  /** Writes every complete byte to the file, then flushes the file. */
+  flush(): void;
+}
+
+/** Reads bit fields from a NativeFile, which must be readable. Other IFile implementations are rejected with a TypeError. */
+export const BitReader = _NativeBitReader as new (file: INativeFile, order?: BitOrder) => IBitReader;
+
+/** Writes bit fields to a NativeFile, which must be writable. Other IFile implementations are rejected with a TypeError. */
+export const BitWriter = _NativeBitWriter as new (file: INativeFile, order?: BitOrder) => IBitWriter;
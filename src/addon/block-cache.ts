@@ -0,0 +1,43 @@
+import { setBlockCache as _setBlockCache, cacheStats as _cacheStats } from '.';
+
+/** Statistics of the block cache, returned by cacheStats. */
+export interface CacheStats {
+  /** The memory budget in bytes. */
+  readonly budget: number;
+  /** The size of a block in bytes. */
+  readonly blockSize: number;
+  /** The maximum number of blocks that fit in the budget. */
+  readonly capacity: number;
+  /** The number of blocks currently cached. */
+  readonly blocks: number;
+  /** The number of bytes currently cached. */
+  readonly bytes: number;
+  /** The number of reads served from a cached block. */
+  readonly hits: number;
+  /** The number of reads that had to go to the file. */
+  readonly misses: number;
+  /** The number of blocks evicted to make room for another one. */
+  readonly evictions: number;
+  /** The number of blocks dropped because their file was written or has changed. */
+  readonly invalidations: number;
+}
+
+/**
+ * Enables, resizes or disables the process-wide block cache, which is shared by every NativeFile opened on the same file.
+ * Only NativeFile instances created while the cache is enabled read through it, and only if they are readable and opened on a regular file.
+ * Such a NativeFile doesn't move the position of its file descriptor when reading, until its buffering is disabled with `setBufSize(0)`, which also stops it from using the cache.
+ * Cached blocks are dropped when a NativeFile writes to (and flushes) the same file, or is opened on it for writing.
+ * Changes made by other means (fs module, other processes) are only detected when a NativeFile is opened, by comparing the size and modification time of the file,
+ * so a NativeFile that was already open may still read the old content.
+ * Blocks are evicted with the CLOCK algorithm when the budget is full. Any call clears the cache and its statistics.
+ * @param budget The memory budget in bytes, use the value 0 to disable the cache.
+ * @param blockSize The size of a block in bytes, at least 512. Default to 65536.
+ */
+export function setBlockCache(budget: number, blockSize?: number): void {
+  _setBlockCache(budget, blockSize);
+}
+
+/** Returns the statistics of the block cache, which help sizing its budget. */
+export function cacheStats(): CacheStats {
+  return _cacheStats();
+}
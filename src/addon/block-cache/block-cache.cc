@@ -0,0 +1,324 @@
+#include "block-cache.h"
+#include <napi.h>
+#include <uv.h>
+#include <cstring>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+#include "../utils/utils.h"
+#include "../exception-handler/exception-handler.h"
+
+namespace BlockCache {
+   struct FileKeyHash {
+      size_t operator()(const FileKey &key) const {
+         return std::hash<uint64_t>()(key.dev) * 31 + std::hash<uint64_t>()(key.ino);
+      }
+   };
+
+   struct Slot {
+      FileKey key;
+      uint64_t blockNo = 0;
+      bool referenced = false;
+      size_t length = 0; // less than blockSize for the last block of a file
+      std::unique_ptr<char[]> data;
+   };
+
+   struct FileEntry {
+      FileVersion version;
+      std::unordered_map<uint64_t, size_t> blocks;
+   };
+
+   struct Stats {
+      double hits = 0;
+      double misses = 0;
+      double evictions = 0;
+      double invalidations = 0;
+   };
+
+   // Every variable below is guarded by mutex, enabled only mirrors !slots.empty() for a lock-free check.
+   static std::mutex mutex;
+   static std::atomic<bool> enabled(false);
+   static size_t budget = 0;
+   static size_t blockSize = DEFAULT_BLOCK_SIZE;
+   static std::vector<Slot> slots;
+   static std::vector<size_t> freeSlots;
+   static size_t hand = 0;
+   // bumped by every invalidation, so that a block read outside of the lock is not cached if it may be outdated
+   static uint64_t generation = 0;
+   static Stats stats;
+   static std::unordered_map<FileKey, FileEntry, FileKeyHash> index;
+
+   static Slot *Find(const FileKey &key, uint64_t blockNo) {
+      auto file = index.find(key);
+      if (file == index.end()) return NULL;
+      auto block = file->second.blocks.find(blockNo);
+      if (block == file->second.blocks.end()) return NULL;
+      return &slots[block->second];
+   }
+
+   static size_t AcquireSlot() {
+      if (!freeSlots.empty()) {
+         auto i = freeSlots.back();
+         freeSlots.pop_back();
+         return i;
+      }
+      // every slot is in use, sweep until a block that hasn't been hit since the last sweep shows up
+      for (;;) {
+         auto i = hand;
+         hand = (hand + 1) % slots.size();
+         auto &slot = slots[i];
+         if (slot.referenced) {
+            slot.referenced = false;
+            continue;
+         }
+         auto file = index.find(slot.key);
+         file->second.blocks.erase(slot.blockNo);
+         if (file->second.blocks.empty()) index.erase(file);
+         stats.evictions++;
+         return i;
+      }
+   }
+
+   static void Insert(const FileKey &key, const FileVersion &version, uint64_t blockNo, std::unique_ptr<char[]> data, size_t length, bool referenced) {
+      auto i = AcquireSlot();
+      auto &slot = slots[i];
+      slot.key = key;
+      slot.blockNo = blockNo;
+      slot.referenced = referenced;
+      slot.length = length;
+      slot.data = std::move(data);
+      auto &file = index[key];
+      if (file.blocks.empty())
+         file.version = version;
+      file.blocks[blockNo] = i;
+   }
+
+   // Frees every block of the file, the caller holds the lock.
+   static void Drop(const FileKey &key) {
+      generation++;
+      auto file = index.find(key);
+      if (file == index.end()) return;
+      for (auto &block : file->second.blocks) {
+         auto &slot = slots[block.second];
+         slot.referenced = false;
+         slot.data.reset();
+         freeSlots.push_back(block.second);
+         stats.invalidations++;
+      }
+      index.erase(file);
+   }
+
+   static size_t CopyOut(const char *data, size_t length, size_t inBlock, void *ptr, size_t count) {
+      if (inBlock >= length) return 0;
+      auto n = length - inBlock < count ? length - inBlock : count;
+      memcpy(ptr, data + inBlock, n);
+      return n;
+   }
+
+   static void Configure(size_t newBudget, size_t newBlockSize) {
+      // allocate the new tables before touching the current ones, so that a failure leaves the cache as it was
+      auto count = newBudget / newBlockSize;
+      std::vector<Slot> newSlots;
+      std::vector<size_t> newFreeSlots;
+      try {
+         newSlots.resize(count);
+         newFreeSlots.reserve(count);
+      } catch (const std::bad_alloc &) {
+         throw NodeException(NodeError::Range, "Not enough memory to hold " + std::to_string(count) + " blocks.");
+      } catch (const std::length_error &) {
+         throw NodeException(NodeError::Range, "Not enough memory to hold " + std::to_string(count) + " blocks.");
+      }
+      for (size_t i = count; i > 0; i--)
+         newFreeSlots.push_back(i - 1);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      index.clear();
+      // the old blocks are freed along with the locals once the lock is released
+      slots.swap(newSlots);
+      freeSlots.swap(newFreeSlots);
+      hand = 0;
+      generation++;
+      stats = Stats();
+      budget = newBudget;
+      blockSize = newBlockSize;
+      enabled = count != 0;
+   }
+
+#ifdef _WIN32
+   static int64_t FileTimeToInt(const FILETIME &time) {
+      return (int64_t)(((uint64_t)time.dwHighDateTime << 32) | time.dwLowDateTime);
+   }
+   bool GetFileKey(int fd, FileKey *key, FileVersion *version) {
+      auto handle = GetWindowsHandle(fd);
+      if (GetFileType(handle) != FILE_TYPE_DISK)
+         return false;
+      BY_HANDLE_FILE_INFORMATION info;
+      if (!GetFileInformationByHandle(handle, &info) || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+         return false;
+      key->dev = info.dwVolumeSerialNumber;
+      key->ino = ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+      version->size = ((uint64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+      version->mtime = FileTimeToInt(info.ftLastWriteTime);
+      // there is no change time here, the creation time tells a recreated file apart
+      version->ctime = FileTimeToInt(info.ftCreationTime);
+      return true;
+   }
+#else
+   static int64_t TimespecToInt(const struct timespec &time) {
+      return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+   }
+   bool GetFileKey(int fd, FileKey *key, FileVersion *version) {
+      struct stat st;
+      if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+         return false;
+      key->dev = (uint64_t)st.st_dev;
+      key->ino = (uint64_t)st.st_ino;
+      version->size = (uint64_t)st.st_size;
+#ifdef __APPLE__
+      version->mtime = TimespecToInt(st.st_mtimespec);
+      version->ctime = TimespecToInt(st.st_ctimespec);
+#else
+      version->mtime = TimespecToInt(st.st_mtim);
+      version->ctime = TimespecToInt(st.st_ctim);
+#endif
+      return true;
+   }
+#endif
+
+   bool IsEnabled() {
+      return enabled;
+   }
+
+   size_t Read(const FileKey &key, const FileVersion &version, int fd, int64_t pos, void *ptr, size_t count) {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (slots.empty()) {
+         lock.unlock();
+         return ReadFileAt(fd, ptr, count, pos);
+      }
+      auto size = blockSize;
+      auto blockNo = (uint64_t)pos / size;
+      auto inBlock = (size_t)((uint64_t)pos % size);
+      // a bulk read only keeps its blocks if they take at most a quarter of the cache
+      auto maxScanBlocks = slots.size() / 4;
+      auto *slot = Find(key, blockNo);
+      if (slot != NULL) {
+         stats.hits++;
+         slot->referenced = true;
+         return CopyOut(slot->data.get(), slot->length, inBlock, ptr, count);
+      }
+      stats.misses++;
+      auto startGeneration = generation;
+      lock.unlock();
+
+      if (inBlock == 0 && count >= size) {
+         // read the whole blocks straight into ptr, and cache them unreferenced,
+         // so that the CLOCK hand evicts them before any block that has been hit again
+         auto runBlocks = count / size;
+         auto n = ReadFileAt(fd, ptr, runBlocks * size, pos);
+         if (runBlocks > maxScanBlocks)
+            return n;
+         std::vector<std::unique_ptr<char[]>> blocks;
+         for (size_t offset = 0; offset < n; offset += size) {
+            auto length = n - offset < size ? n - offset : size;
+            blocks.emplace_back(new char[length]);
+            memcpy(blocks.back().get(), (const char *)ptr + offset, length);
+         }
+         lock.lock();
+         if (generation == startGeneration) {
+            for (size_t i = 0; i < blocks.size(); i++) {
+               auto length = n - i * size < size ? n - i * size : size;
+               if (Find(key, blockNo + i) == NULL)
+                  Insert(key, version, blockNo + i, std::move(blocks[i]), length, false);
+            }
+         }
+         return n;
+      }
+
+      std::unique_ptr<char[]> data(new char[size]);
+      auto length = ReadFileAt(fd, data.get(), size, (int64_t)(blockNo * size));
+      auto n = CopyOut(data.get(), length, inBlock, ptr, count);
+
+      // a block at or past EOF holds nothing worth keeping
+      if (length == 0)
+         return n;
+      lock.lock();
+      if (generation == startGeneration && Find(key, blockNo) == NULL)
+         Insert(key, version, blockNo, std::move(data), length, true);
+      return n;
+   }
+
+   void Invalidate(const FileKey &key) {
+      if (!enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+      Drop(key);
+   }
+
+   void Validate(const FileKey &key, const FileVersion &version) {
+      if (!enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+      auto file = index.find(key);
+      if (file != index.end() && file->second.version != version)
+         Drop(key);
+   }
+
+   // setBlockCache(budget: number, blockSize?: number): void
+   static void SetBlockCache(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto inputError = IsSafeInteger(info[0], sizeof(size_t), true);
+         if (inputError == IntegerInvalid::Type) // budget
+            throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(size_t), "first argument", true));
+         else if (inputError == IntegerInvalid::Range) // budget
+            throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), "first argument", true));
+
+         if (!IsNullOrUndefined(info[1])) {
+            auto inputError = IsSafeInteger(info[1], sizeof(size_t), true);
+            if (inputError == IntegerInvalid::Type) // blockSize
+               throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(size_t), "second argument", true));
+            else if (inputError == IntegerInvalid::Range) // blockSize
+               throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), "second argument", true));
+         }
+
+         auto newBudget = (size_t)info[0].As<Napi::Number>().DoubleValue();
+         auto newBlockSize = (size_t)TRY_GET_NUMBER(info[1], DEFAULT_BLOCK_SIZE);
+         if (newBlockSize < MIN_BLOCK_SIZE)
+            throw NodeException(NodeError::Range, "blockSize must be at least " + std::to_string(MIN_BLOCK_SIZE) + ".");
+         Configure(newBudget, newBlockSize);
+      });
+   }
+
+   // cacheStats(): CacheStats
+   static Napi::Value CacheStats(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      std::lock_guard<std::mutex> lock(mutex);
+      double bytes = 0;
+      for (auto &file : index)
+         for (auto &block : file.second.blocks)
+            bytes += (double)slots[block.second].length;
+      auto rs = Napi::Object::New(env);
+      rs.Set("budget", (double)budget);
+      rs.Set("blockSize", (double)blockSize);
+      rs.Set("capacity", (double)slots.size());
+      rs.Set("blocks", (double)(slots.size() - freeSlots.size()));
+      rs.Set("bytes", bytes);
+      rs.Set("hits", stats.hits);
+      rs.Set("misses", stats.misses);
+      rs.Set("evictions", stats.evictions);
+      rs.Set("invalidations", stats.invalidations);
+      return rs;
+   }
+
+   void Prepare(Napi::Env env, Napi::Object exports) {
+      exports.Set("SetBlockCache", Napi::Function::New(env, SetBlockCache, "setBlockCache"));
+      exports.Set("CacheStats", Napi::Function::New(env, CacheStats, "cacheStats"));
+   }
+}
@@ -0,0 +1,56 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <napi.h>
+#include <uv.h>
+#include <cstdint>
+#include <cstddef>
+// A process-wide cache of file blocks, shared by every File opened on the same file.
+// Blocks are keyed by device/inode plus block number, and evicted with the CLOCK algorithm once the budget is full.
+namespace BlockCache {
+   void Prepare(Napi::Env env, Napi::Object exports);
+
+   const size_t DEFAULT_BLOCK_SIZE = 65536;
+   // keeps the per-block bookkeeping, which is not counted in the budget, small next to the data
+   const size_t MIN_BLOCK_SIZE = 512;
+
+   struct FileKey {
+      uint64_t dev = 0;
+      uint64_t ino = 0;
+      bool operator==(const FileKey &other) const {
+         return dev == other.dev && ino == other.ino;
+      }
+   };
+
+   // What the file looked like when a File opened it, a mismatch means the inode was reused or rewritten behind our back.
+   struct FileVersion {
+      uint64_t size = 0;
+      int64_t mtime = 0;
+      int64_t ctime = 0;
+      bool operator==(const FileVersion &other) const {
+         return size == other.size && mtime == other.mtime && ctime == other.ctime;
+      }
+      bool operator!=(const FileVersion &other) const {
+         return !(*this == other);
+      }
+   };
+
+   // Gets the identity and version of the file behind fd, returns false if it's not a regular file.
+   bool GetFileKey(int fd, FileKey *key, FileVersion *version);
+
+   bool IsEnabled();
+
+   // Reads from the block containing pos, returns the number of bytes copied into ptr (at most count), 0 at EOF.
+   // Whole blocks read in bulk are cached as not yet referenced, so that a scan doesn't push hot blocks out,
+   // and a bulk read larger than a quarter of the cache is not cached at all.
+   // Blocks inserted for a file that has none cached yet are tagged with version.
+   size_t Read(const FileKey &key, const FileVersion &version, int fd, int64_t pos, void *ptr, size_t count);
+
+   // Drops every cached block of the file if they were read from another version of it, called when a File is opened.
+   void Validate(const FileKey &key, const FileVersion &version);
+
+   // Drops every cached block of the file, called whenever a File writes to it.
+   void Invalidate(const FileKey &key);
+}
+
+#endif // !BLOCK_CACHE_H
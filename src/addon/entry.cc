@@ -2,6 +2,9 @@
 #include <uv.h>
 #include "utils/utils.h"
 #include "file-wrap/file-wrap.h"
+#include "bit-wrap/bit-wrap.h"
+#include "block-cache/block-cache.h"
+#include "read-many/read-many.h"
 #include "constants/constants.h"
 #ifdef _WIN32
 static void invalid_parameter_function(LPCWSTR a, LPCWSTR b, LPCWSTR c, UINT d, uintptr_t e) {
@@ -15,6 +18,9 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
    ImportNtDllFunctions();
 #endif
    FileWrap::Prepare(env, exports);
+   BitWrap::Prepare(env, exports);
+   BlockCache::Prepare(env, exports);
+   ReadMany::Prepare(env, exports);
    Constants::Prepare(env, exports);
    return exports;
 }
@@ -23,38 +23,70 @@ public:
    inline ReferenceError(napi_env env, napi_value value) : Error(env, value) {}
 };
 
+NodeException CSException(NodeError type, std::string csCode, std::string message) {
+   NodeException e(type, message);
+   e.csCode = csCode;
+   return e;
+}
+
+static Napi::Error SetCSCode(Napi::Error err, const NodeException &e) {
+   if (e.csCode.length() != 0)
+      err.Set("code", e.csCode);
+   return err;
+}
+
+Napi::Error CreateNodeError(Napi::Env env, const NodeException &e) {
+   switch (e.type) {
+      case NodeError::Range:
+         return SetCSCode(Napi::RangeError::New(env, e.what()), e);
+      case NodeError::Reference:
+         // waiting for a day that Napi would have ReferenceError
+         return SetCSCode(ReferenceError::New(env, e.what()), e);
+      case NodeError::Type:
+         return SetCSCode(Napi::TypeError::New(env, e.what()), e);
+      case NodeError::Errno: {
+         auto func = e.func.length() == 0 ? NULL : e.func.c_str();
+         auto message = e.message.length() == 0 ? NULL : e.message.c_str();
+         auto path = e.path.length() == 0 ? NULL : e.path.c_str();
+         auto code = errnoname(errno);
+         std::string msg;
+         if (message != NULL)
+            msg = (code ? code : std::to_string(errno)) + std::string(": ") + strerror(errno) + " (" + message + ")";
+         else
+            msg = (code ? code : std::to_string(errno)) + std::string(": ") + strerror(errno);
+         auto err = Napi::Error::New(env, msg);
+         err.Set("code", code);
+         err.Set("errno", (double)errno);
+         err.Set("syscall", func);
+         err.Set("path", path);
+         return err;
+      }
+      case NodeError::Uv: {
+         // libuv error codes are portable, unlike the errno values on Windows
+         auto func = e.func.length() == 0 ? NULL : e.func.c_str();
+         auto path = e.path.length() == 0 ? NULL : e.path.c_str();
+         auto code = uv_err_name(e.code);
+         std::string msg = code + std::string(": ") + uv_strerror(e.code);
+         if (e.message.length() != 0)
+            msg += " (" + e.message + ")";
+         auto err = Napi::Error::New(env, msg);
+         err.Set("code", code);
+         err.Set("errno", (double)e.code);
+         err.Set("syscall", func);
+         err.Set("path", path);
+         return err;
+      }
+      case NodeError::Generic:
+      default:
+         return SetCSCode(Napi::Error::New(env, e.what()), e);
+   }
+}
+
 void HandleException(Napi::Env env, std::function<void()> f) {
    try {
       f();
    } catch (NodeException &e) {
-      switch (e.type) {
-         case NodeError::Generic:
-            return Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
-         case NodeError::Range:
-            return Napi::RangeError::New(env, e.what()).ThrowAsJavaScriptException();
-         case NodeError::Reference:
-            // waiting for a day that Napi would have ReferenceError
-            return ReferenceError::New(env, e.what()).ThrowAsJavaScriptException();
-         case NodeError::Type:
-            return Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
-         case NodeError::Errno: {
-            auto func = e.func.length() == 0 ? NULL : e.func.c_str();
-            auto message = e.message.length() == 0 ? NULL : e.message.c_str();
-            auto path = e.path.length() == 0 ? NULL : e.path.c_str();
-            auto code = errnoname(errno);
-            std::string msg;
-            if (message != NULL)
-               msg = (code ? code : std::to_string(errno)) + std::string(": ") + strerror(errno) + " (" + message + ")";
-            else
-               msg = (code ? code : std::to_string(errno)) + std::string(": ") + strerror(errno);
-            auto err = Napi::Error::New(env, msg);
-            err.Set("code", code);
-            err.Set("errno", (double)errno);
-            err.Set("syscall", func);
-            err.Set("path", path);
-            return err.ThrowAsJavaScriptException();
-         }
-      }
+      return CreateNodeError(env, e).ThrowAsJavaScriptException();
    } catch (std::exception &e) {
       return Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
    }
@@ -7,7 +7,7 @@
 #include <cstring>
 
 enum class NodeError {
-   Range, Reference, Generic, Type, Errno
+   Range, Reference, Generic, Type, Errno, Uv
 };
 
 class NodeException : public std::exception {
@@ -16,10 +16,16 @@ public:
    std::string message;
    std::string func;
    std::string path;
+   int code = 0; // libuv error code, only meaningful for NodeError::Uv
+   std::string csCode; // CSCode value set as the code property of the error, if any
    NodeException(NodeError type, std::string message = "", std::string func = "", std::string path = "");
    const char *what() const noexcept;
 };
 
+NodeException CSException(NodeError type, std::string csCode, std::string message);
+
+Napi::Error CreateNodeError(Napi::Env env, const NodeException &e);
+
 void HandleException(Napi::Env env, std::function<void()> f);
 
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "file-wrap.h"
 #include <cstdio>
+#include <climits>
 #include <napi.h>
 #include <uv.h>
 #include <uv.h>
@@ -30,7 +31,9 @@ namespace FileWrap {
             InstanceMethod<&File::read>("read"),
             InstanceMethod<&File::write>("write"),
             InstanceMethod<&File::flush>("flush"),
-            InstanceMethod<&File::setBufSize>("setBufSize")
+            InstanceMethod<&File::setBufSize>("setBufSize"),
+            InstanceMethod<&File::readMany>("readMany"),
+            InstanceMethod<&File::readManyAsync>("readManyAsync")
          }
       );
       auto *constructor = new Napi::FunctionReference();
@@ -56,18 +59,112 @@ namespace FileWrap {
          this->fd = fd;
          this->file = file;
          this->state = state;
+         this->hasCacheKey = state.canSeek && BlockCache::GetFileKey(fd, &this->cacheKey, &this->cacheVersion);
+         // the file may have been truncated, rewritten or replaced by a new one on a reused inode since its blocks were cached
+         if (this->hasCacheKey) {
+            if (state.canWrite)
+               BlockCache::Invalidate(this->cacheKey);
+            else
+               BlockCache::Validate(this->cacheKey, this->cacheVersion);
+         }
+         this->useCache = this->hasCacheKey && state.canRead && BlockCache::IsEnabled();
+         if (this->useCache)
+            this->pos = TellFile(file);
       });
    }
-   void File::ThrowIfClosed(const Napi::CallbackInfo &info) {
+   File *File::FromValue(Napi::Env env, Napi::Value value) {
+      auto *constructor = env.GetInstanceData<Napi::FunctionReference>();
+      if (!value.IsObject() || !value.As<Napi::Object>().InstanceOf(constructor->Value()))
+         return NULL;
+      return File::Unwrap(value.As<Napi::Object>());
+   }
+   void File::ThrowIfClosed() {
       if (this->isClose)
          THROW_ERRNO_EX(EBADF, "");
    }
+   void File::Seek(long offset, int origin) {
+      ThrowIfClosed();
+      // fseek writes the pending output out, a reader may have cached the old content since our last write
+      if (this->dirty)
+         Flush();
+      if (this->useCache && origin == SEEK_CUR) {
+         // the position of the stream is stale after cached reads
+         auto target = this->pos + offset;
+         if (target > LONG_MAX)
+            THROW_ERRNO_EX(EOVERFLOW, "");
+         offset = (long)target;
+         origin = SEEK_SET;
+      }
+      SeekFile(this->file, offset, origin);
+      if (this->useCache) {
+         this->pos = TellFile(this->file);
+         this->streamPosValid = true;
+      }
+   }
+   int64_t File::Tell() {
+      ThrowIfClosed();
+      if (this->useCache)
+         return this->pos;
+      return TellFile(this->file);
+   }
+   size_t File::Read(void *ptr, size_t count) {
+      ThrowIfClosed();
+      if (!this->useCache)
+         return ReadFile(this->file, ptr, 1, count);
+      // the cache reads the file itself, so our own buffered writes must reach it first
+      if (this->dirty)
+         Flush();
+      size_t nRead = 0;
+      while (nRead < count) {
+         auto n = BlockCache::Read(this->cacheKey, this->cacheVersion, this->fd, this->pos, (char *)ptr + nRead, count - nRead);
+         if (n == 0) break;
+         nRead += n;
+         this->pos += n;
+      }
+      if (nRead != 0)
+         this->streamPosValid = false;
+      return nRead;
+   }
+   void File::Write(const void *ptr, size_t count) {
+      ThrowIfClosed();
+      if (this->useCache && !this->streamPosValid && !this->state.canAppend) {
+         SeekFile(this->file, (long)this->pos, SEEK_SET);
+         this->streamPosValid = true;
+      }
+      WriteFile(this->file, ptr, 1, count);
+      if (this->useCache)
+         this->pos = this->state.canAppend ? TellFile(this->file) : this->pos + (int64_t)count;
+      if (this->hasCacheKey) {
+         BlockCache::Invalidate(this->cacheKey);
+         this->dirty = true;
+      }
+   }
+   void File::Flush() {
+      ThrowIfClosed();
+      FlushFile(this->file);
+      if (this->dirty) {
+         BlockCache::Invalidate(this->cacheKey);
+         this->dirty = false;
+      }
+   }
+   int64_t File::Size() {
+      auto pos = Tell();
+      Seek(0, SEEK_END);
+      auto size = Tell();
+      Seek((long)pos, SEEK_SET);
+      return size;
+   }
    // close(): void
    void File::close(const Napi::CallbackInfo &info) {
       auto env = info.Env();
       HandleException(env, [&]() {
          if (this->isClose) return;
+         if (this->pendingReads != 0)
+            THROW_ERRNO_EX(EBUSY, "There are unsettled readManyAsync calls on this file.");
          CloseFile(this->file);
+         if (this->dirty) BlockCache::Invalidate(this->cacheKey);
+         this->dirty = false;
+         this->useCache = false;
          this->fd = -1;
          this->file = NULL;
          this->state = IOState();
@@ -78,7 +175,7 @@ namespace FileWrap {
    void File::seek(const Napi::CallbackInfo &info) {
       auto env = info.Env();
       HandleException(env, [&] {
-         ThrowIfClosed(info);
+         ThrowIfClosed();
 
          auto inputError = IsSafeInteger(info[0], sizeof(long));
          if (inputError == IntegerInvalid::Type) // offset
@@ -93,7 +190,7 @@ namespace FileWrap {
          auto origin = info[1].As<Napi::Number>().Int32Value();
          if (origin != SEEK_SET && origin != SEEK_CUR && origin != SEEK_END)
             throw NodeException(NodeError::Range, "Invalid SeekOrigin value.");
-         SeekFile(this->file, offset, origin);
+         Seek(offset, origin);
       });
    }
    // tell(): number
@@ -101,8 +198,8 @@ namespace FileWrap {
       auto env = info.Env();
       Napi::Value rs;
       HandleException(env, [&]() {
-         ThrowIfClosed(info);
-         auto pos = TellFile(this->file);
+         ThrowIfClosed();
+         auto pos = Tell();
          THROW_IF_NOT_SAFE_NUMBER(pos);
          rs = Napi::Number::New(env, (double)pos);
       });
@@ -113,7 +210,7 @@ namespace FileWrap {
       auto env = info.Env();
       Napi::Value rs;
       HandleException(env, [&]() {
-         ThrowIfClosed(info);
+         ThrowIfClosed();
 
          if (!info[0].IsBuffer()) // bytes
             throw NodeException(NodeError::Type, "Must provide a Buffer value as the first argument.");
@@ -141,7 +238,7 @@ namespace FileWrap {
          auto count = (size_t)TRY_GET_NUMBER(info[2], byteLen - offset);
          if (byteLen - offset < count)
             throw NodeException(NodeError::Range, "Your requested read range would cause buffer overflow.");
-         auto nRead = ReadFile(this->file, bytes.Data() + offset, 1, count);
+         auto nRead = Read(bytes.Data() + offset, count);
          rs = Napi::Number::New(env, (double)nRead);
       });
       return rs;
@@ -150,7 +247,7 @@ namespace FileWrap {
    void File::write(const Napi::CallbackInfo &info) {
       auto env = info.Env();
       HandleException(env, [&]() {
-         ThrowIfClosed(info);
+         ThrowIfClosed();
 
          if (!info[0].IsBuffer()) // bytes
             throw NodeException(NodeError::Type, "Must provide a Buffer value as the first argument.");
@@ -179,22 +276,21 @@ namespace FileWrap {
          auto count = (size_t)TRY_GET_NUMBER(info[2], byteLen - offset);
          if (byteLen - offset < count)
             throw NodeException(NodeError::Range, "Your requested read range would cause buffer overflow.");
-         WriteFile(this->file, bytes.Data() + offset, 1, count);
+         Write(bytes.Data() + offset, count);
       });
    }
    // flush(): void
    void File::flush(const Napi::CallbackInfo &info) {
       auto env = info.Env();
       HandleException(env, [&]() {
-         ThrowIfClosed(info);
-         FlushFile(this->file);
+         Flush();
       });
    }
    // setBufSize(size: number): void
    void File::setBufSize(const Napi::CallbackInfo &info) {
       auto env = info.Env();
       HandleException(env, [&]() {
-         ThrowIfClosed(info);
+         ThrowIfClosed();
 
          auto inputError = IsSafeInteger(info[0], sizeof(size_t), true);
          if (inputError == IntegerInvalid::Type) // size
@@ -203,10 +299,123 @@ namespace FileWrap {
             throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), "first argument", true));
 
          auto size = (size_t)info[0].As<Napi::Number>().DoubleValue();
+         if (size == 0 && this->useCache) {
+            // unbuffered reads must move the file descriptor, so stop serving them from the block cache
+            if (this->dirty)
+               Flush();
+            SeekFile(this->file, (long)this->pos, SEEK_SET);
+            this->streamPosValid = true;
+            this->useCache = false;
+         }
          if (size != 0)
             SetFileBufSize(this->file, NULL, _IOFBF, size);
          else
             SetFileBufSize(this->file, NULL, _IONBF, 0);
       });
    }
+   // Validates the extent list of readMany and readManyAsync, then flushes pending writes so that the reads can see them.
+   std::vector<ReadMany::Extent> File::PrepareReadMany(
+      const Napi::CallbackInfo &info, std::vector<Napi::Reference<Napi::Buffer<char>>> *keepAlive) {
+      ThrowIfClosed();
+
+      if (!info[0].IsArray()) // extents
+         throw NodeException(NodeError::Type, "Must provide an array of extents as the first argument.");
+
+      auto array = info[0].As<Napi::Array>();
+      std::vector<ReadMany::Extent> extents;
+      extents.reserve(array.Length());
+      for (uint32_t i = 0; i < array.Length(); i++) {
+         auto element = array.Get(i);
+         auto name = "extent " + std::to_string(i);
+         if (!element.IsObject())
+            throw NodeException(NodeError::Type, name + " must be an object.");
+         auto extent = element.As<Napi::Object>();
+
+         auto target = extent.Get("target");
+         if (!target.IsBuffer())
+            throw NodeException(NodeError::Type, "Must provide a Buffer value as target of " + name + ".");
+
+         // read each property once, a getter may return something else the second time
+         auto offset = extent.Get("offset");
+         auto offsetArg = "offset of " + name;
+         auto inputError = IsSafeInteger(offset, sizeof(int64_t), true);
+         if (inputError == IntegerInvalid::Type)
+            throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(int64_t), offsetArg.c_str(), true));
+         else if (inputError == IntegerInvalid::Range)
+            throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(int64_t), offsetArg.c_str(), true));
+
+         auto length = extent.Get("length");
+         if (!IsNullOrUndefined(length)) {
+            auto lengthArg = "length of " + name;
+            auto inputError = IsSafeInteger(length, sizeof(size_t), true);
+            if (inputError == IntegerInvalid::Type)
+               throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(size_t), lengthArg.c_str(), true));
+            else if (inputError == IntegerInvalid::Range)
+               throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), lengthArg.c_str(), true));
+         }
+
+         auto bytes = target.As<Napi::Buffer<char>>();
+         auto byteLen = bytes.Length();
+         auto count = (size_t)TRY_GET_NUMBER(length, byteLen);
+         if (count > byteLen)
+            throw NodeException(NodeError::Range, "Your requested read range of " + name + " would cause buffer overflow.");
+
+         extents.push_back({ (int64_t)offset.As<Napi::Number>().DoubleValue(), bytes.Data(), count });
+         if (keepAlive != NULL)
+            keepAlive->push_back(Napi::Persistent(bytes));
+      }
+
+      if (this->state.canWrite)
+         Flush();
+      return extents;
+   }
+   // readMany(extents: ReadExtent[]): number[]
+   Napi::Value File::readMany(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      Napi::Value rs;
+      HandleException(env, [&]() {
+         auto extents = PrepareReadMany(info, NULL);
+         auto bytesRead = ReadMany::ReadSync(this->fd, std::move(extents));
+         auto arr = Napi::Array::New(env, bytesRead.size());
+         for (size_t i = 0; i < bytesRead.size(); i++)
+            arr.Set((uint32_t)i, Napi::Number::New(env, (double)bytesRead[i]));
+         rs = arr;
+      });
+      return rs;
+   }
+   static Napi::Value RejectedPromise(Napi::Env env, Napi::Value error) {
+      auto deferred = Napi::Promise::Deferred::New(env);
+      deferred.Reject(error);
+      return deferred.Promise();
+   }
+   // readManyAsync(extents: ReadExtent[]): Promise<number[]>
+   Napi::Value File::readManyAsync(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      Napi::Value rs;
+      HandleException(env, [&]() {
+         // every error, including the validation ones, rejects the promise instead of being thrown
+         try {
+            std::vector<Napi::Reference<Napi::Buffer<char>>> keepAlive;
+            auto extents = PrepareReadMany(info, &keepAlive);
+            // keeps this object (and so the file descriptor) alive until every read is done
+            this->Ref();
+            this->pendingReads++;
+            try {
+               rs = ReadMany::ReadAsync(env, this->fd, std::move(extents), std::move(keepAlive), [this]() {
+                  this->pendingReads--;
+                  this->Unref();
+               });
+            } catch (...) {
+               this->pendingReads--;
+               this->Unref();
+               throw;
+            }
+         } catch (NodeException &e) {
+            rs = RejectedPromise(env, CreateNodeError(env, e).Value());
+         } catch (Napi::Error &e) {
+            rs = RejectedPromise(env, e.Value());
+         }
+      });
+      return rs;
+   }
 }
\ No newline at end of file
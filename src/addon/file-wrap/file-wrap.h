@@ -4,18 +4,34 @@
 #include <napi.h>
 #include <uv.h>
 #include <cstdio>
+#include <cerrno>
 #include "../utils/utils.h"
+#include "../read-many/read-many.h"
+#include "../block-cache/block-cache.h"
 namespace FileWrap {
    void Prepare(Napi::Env env, Napi::Object exports);
    class File : public Napi::ObjectWrap<File> {
    public:
       static void Init(Napi::Env env, Napi::Object exports);
       File(const Napi::CallbackInfo &info);
+      // Returns the File wrapped by value, or NULL if value is not a File instance.
+      static File *FromValue(Napi::Env env, Napi::Value value);
+      const IOState &GetState() {
+         return this->state;
+      }
       ~File() {
          if (this->isClose) return;
          if (this->file != NULL) fclose(this->file);
+         if (this->dirty) BlockCache::Invalidate(this->cacheKey);
          this->isClose = true;
       }
+      // Core operations, used by the methods below and by the other native classes working on a File.
+      void Seek(long offset, int origin);
+      int64_t Tell();
+      size_t Read(void *ptr, size_t count);
+      void Write(const void *ptr, size_t count);
+      void Flush();
+      int64_t Size();
 
    private:
       int fd;
@@ -23,6 +39,18 @@ namespace FileWrap {
       IOState state;
 
       bool isClose = false;
+      size_t pendingReads = 0; // number of unsettled readManyAsync calls
+
+      BlockCache::FileKey cacheKey;
+      BlockCache::FileVersion cacheVersion;
+      bool hasCacheKey = false;
+      // Reads are served by the block cache and pos is the real position,
+      // the position of the stream is only brought up to date before writing.
+      bool useCache = false;
+      int64_t pos = 0;
+      bool streamPosValid = true;
+      // Written since the last flush, the cached blocks have to be dropped again once the data reaches the file.
+      bool dirty = false;
       Napi::Value getFd(const Napi::CallbackInfo &info) {
          return Napi::Number::New(info.Env(), this->fd);
       }
@@ -38,7 +66,7 @@ namespace FileWrap {
       Napi::Value getCanAppend(const Napi::CallbackInfo &info) {
          return Napi::Boolean::New(info.Env(), this->state.canAppend);
       }
-      void ThrowIfClosed(const Napi::CallbackInfo &info);
+      void ThrowIfClosed();
       void close(const Napi::CallbackInfo &info);
       void seek(const Napi::CallbackInfo &info);
       Napi::Value tell(const Napi::CallbackInfo &info);
@@ -46,6 +74,10 @@ namespace FileWrap {
       void write(const Napi::CallbackInfo &info);
       void flush(const Napi::CallbackInfo &info);
       void setBufSize(const Napi::CallbackInfo &info);
+      std::vector<ReadMany::Extent> PrepareReadMany(
+         const Napi::CallbackInfo &info, std::vector<Napi::Reference<Napi::Buffer<char>>> *keepAlive);
+      Napi::Value readMany(const Napi::CallbackInfo &info);
+      Napi::Value readManyAsync(const Napi::CallbackInfo &info);
    };
 }
 
@@ -1,6 +1,16 @@
-import { NativeFile as _NativeFile } from '.';
+import { NativeFile as _NativeFile, setReadManyQueueDepth as _setReadManyQueueDepth } from '.';
 import { SeekOrigin } from '../constants/mode';
 
+/** A positional read request used by INativeFile.readMany and INativeFile.readManyAsync. */
+export interface ReadExtent {
+  /** Absolute position in the file to start reading from. */
+  offset: number;
+  /** The number of bytes to read, defaults to the length of `target`. */
+  length?: number;
+  /** A buffer to read data into, from its beginning. */
+  target: Buffer;
+}
+
 /**  */
 export interface IFile {
   readonly fd: number;
@@ -34,7 +44,7 @@ export interface IFile {
   flush(): void;
   /**
    * Specify the size of the underlying buffer for file buffering. The default size is probably 4096 on most systems.
-   * @param size Desired size of the underlying buffer. Use the value 0 to disable file buffering.
+   * @param size Desired size of the underlying buffer. Use the value 0 to disable file buffering, which also stops NativeFile from reading through the block cache.
    */
   setBufSize(size: number): void;
   /**
@@ -55,10 +65,37 @@ export interface IFile {
   readonly canAppend: boolean;
 }
 
+/** The IFile interface plus the operations that only NativeFile provides. */
+export interface INativeFile extends IFile {
+  /**
+   * Reads many extents of the file at once, regardless of the position indicator (which is left untouched).
+   * All extents are queued together on a pool of threads dedicated to readMany and readManyAsync, and may complete in any order,
+   * so the number of reads in flight is the queue depth set by `setReadManyQueueDepth` (16 by default). The libuv threadpool is not used.
+   * Returns the number of bytes read for each extent, which is less than requested only if the end of file is reached.
+   * @param extents The extents to read.
+   */
+  readMany(extents: ReadExtent[]): number[];
+  /**
+   * The asynchronous version of readMany, every error is reported by rejecting the returned promise.
+   * The file cannot be closed until the returned promise is settled.
+   * @param extents The extents to read, their target buffers must not be touched until the returned promise is settled.
+   */
+  readManyAsync(extents: ReadExtent[]): Promise<number[]>;
+}
+
 /** A thin wrapper of \<cstdio\>, implementing the IFile interface. It uses binary mode only. */
-export const NativeFile = _NativeFile as new (fd: number) => IFile;
+export const NativeFile = _NativeFile as new (fd: number) => INativeFile;
+
+/**
+ * Sets the number of threads reading the extents of readMany and readManyAsync, which is the number of reads in flight at once.
+ * The pool is shared by the whole process, threads are started on demand and the extra ones exit when the depth is lowered.
+ * @param depth Between 1 and 1024. Default to 16.
+ */
+export function setReadManyQueueDepth(depth: number): void {
+  _setReadManyQueueDepth(depth);
+}
 
 /** Factory function to create NativeFile instance */
-export function File(fd: number): IFile {
+export function File(fd: number): INativeFile {
   return new NativeFile(fd);
 }
@@ -13,6 +13,26 @@ export const getFileState = addon.GetFileState as (fd: number) => {
 
 export const NativeFile = addon.File;
 
+export const NativeBitReader = addon.BitReader;
+
+export const NativeBitWriter = addon.BitWriter;
+
+export const setReadManyQueueDepth = addon.SetReadManyQueueDepth as (depth: number) => void;
+
+export const setBlockCache = addon.SetBlockCache as (budget: number, blockSize?: number) => void;
+
+export const cacheStats = addon.CacheStats as () => {
+  budget: number;
+  blockSize: number;
+  capacity: number;
+  blocks: number;
+  bytes: number;
+  hits: number;
+  misses: number;
+  evictions: number;
+  invalidations: number;
+};
+
 export const constants = addon.constants as {
   SEEK_SET: number;
   SEEK_CUR: number;
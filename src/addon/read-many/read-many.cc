@@ -0,0 +1,238 @@
+#include "read-many.h"
+#include <napi.h>
+#include <uv.h>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <system_error>
+#include <deque>
+#include "../utils/utils.h"
+#include "../exception-handler/exception-handler.h"
+
+namespace ReadMany {
+   // The extents of one readMany call, they complete out of order on the threads of the pool.
+   class Batch {
+   public:
+      Batch(uv_file fd, std::vector<Extent> extents, std::function<void()> onDone);
+      uv_file fd;
+      std::vector<Extent> extents;
+      std::vector<size_t> bytesRead;
+      // the first libuv error code (negative), or 0 if every read succeeded
+      std::atomic<int> error;
+      // Reads one extent, on a thread of the pool. The thread that completes the last extent calls onDone.
+      void Run(size_t index);
+
+   private:
+      std::atomic<size_t> pending;
+      std::function<void()> onDone;
+   };
+
+   Batch::Batch(uv_file fd, std::vector<Extent> extents, std::function<void()> onDone)
+      : fd(fd), extents(std::move(extents)), error(0), onDone(onDone) {
+      this->bytesRead.resize(this->extents.size());
+      this->pending = this->extents.size();
+   }
+   void Batch::Run(size_t index) {
+      auto &extent = this->extents[index];
+      // once a read has failed, the rest of the batch is only drained
+      if (this->error == 0) {
+         try {
+            // a short read is not EOF, ReadFileAt asks for the rest of the extent
+            this->bytesRead[index] = ReadFileAt(this->fd, extent.data, extent.length, extent.offset);
+         } catch (const NodeException &e) {
+            int expected = 0;
+            this->error.compare_exchange_strong(expected, e.code != 0 ? e.code : UV_EIO);
+         } catch (...) {
+            int expected = 0;
+            this->error.compare_exchange_strong(expected, UV_ENOMEM);
+         }
+      }
+      if (--this->pending == 0) {
+         // onDone may destroy this batch, so take it out before calling it
+         auto onDone = std::move(this->onDone);
+         onDone();
+      }
+   }
+
+   struct Task {
+      Batch *batch;
+      size_t index;
+   };
+
+   // Allocated once and never freed, detached threads may still be waiting on it when the process exits.
+   struct Pool {
+      std::mutex mutex;
+      std::condition_variable wakeUp;
+      std::deque<Task> tasks;
+      size_t depth = DEFAULT_QUEUE_DEPTH;
+      size_t threadCount = 0;
+   };
+
+   static Pool &GetPool() {
+      static auto *pool = new Pool();
+      return *pool;
+   }
+
+   static void Work() {
+      auto &pool = GetPool();
+      std::unique_lock<std::mutex> lock(pool.mutex);
+      for (;;) {
+         if (pool.threadCount > pool.depth) {
+            pool.threadCount--;
+            return;
+         }
+         if (pool.tasks.empty()) {
+            pool.wakeUp.wait(lock);
+            continue;
+         }
+         auto task = pool.tasks.front();
+         pool.tasks.pop_front();
+         lock.unlock();
+         task.batch->Run(task.index);
+         lock.lock();
+      }
+   }
+
+   static void Submit(Batch *batch) {
+      auto &pool = GetPool();
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      auto wanted = pool.tasks.size() + batch->extents.size();
+      // start the threads before queueing, so that nothing is left behind if not even one can be started
+      while (pool.threadCount < pool.depth && pool.threadCount < wanted) {
+         try {
+            std::thread(Work).detach();
+         } catch (const std::system_error &e) {
+            if (pool.threadCount == 0)
+               throw NodeException(NodeError::Generic, std::string("Cannot start a thread to read the file: ") + e.what());
+            break;
+         }
+         pool.threadCount++;
+      }
+      for (size_t i = 0; i < batch->extents.size(); i++)
+         pool.tasks.push_back({ batch, i });
+      pool.wakeUp.notify_all();
+   }
+
+   void SetQueueDepth(size_t depth) {
+      auto &pool = GetPool();
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      pool.depth = depth;
+      // the idle threads over the new depth exit right away
+      pool.wakeUp.notify_all();
+   }
+
+   std::vector<size_t> ReadSync(uv_file fd, std::vector<Extent> extents) {
+      if (extents.empty())
+         return std::vector<size_t>();
+      std::mutex doneMutex;
+      std::condition_variable doneSignal;
+      bool done = false;
+      Batch batch(fd, std::move(extents), [&]() {
+         std::lock_guard<std::mutex> lock(doneMutex);
+         done = true;
+         doneSignal.notify_one();
+      });
+      Submit(&batch);
+      {
+         std::unique_lock<std::mutex> lock(doneMutex);
+         doneSignal.wait(lock, [&]() { return done; });
+      }
+      if (batch.error != 0)
+         THROW_UV(batch.error, "");
+      return batch.bytesRead;
+   }
+
+   struct AsyncState {
+      Napi::Env env;
+      Napi::Promise::Deferred deferred;
+      Napi::AsyncContext context;
+      std::vector<Napi::Reference<Napi::Buffer<char>>> keepAlive;
+      std::function<void()> onSettled;
+      // wakes the loop of env up once the pool is done with the batch
+      uv_async_t async;
+      Batch batch;
+      AsyncState(
+         Napi::Env env, uv_file fd, std::vector<Extent> extents,
+         std::vector<Napi::Reference<Napi::Buffer<char>>> keepAlive, std::function<void()> onSettled)
+         : env(env), deferred(Napi::Promise::Deferred::New(env)), context(env, "csbinary:readMany"),
+         keepAlive(std::move(keepAlive)), onSettled(onSettled),
+         batch(fd, std::move(extents), [this]() { uv_async_send(&this->async); }) {}
+
+      void Settle() {
+         Napi::HandleScope scope(this->env);
+         // makes sure the promise reactions run right after this callback, like any other libuv callback
+         Napi::CallbackScope callbackScope(this->env, this->context);
+         if (this->onSettled) this->onSettled();
+         if (this->batch.error != 0) {
+            NodeException e(NodeError::Uv, "", "ReadAsync", CURRENT_PATH);
+            e.code = this->batch.error;
+            this->deferred.Reject(CreateNodeError(this->env, e).Value());
+         } else {
+            auto rs = Napi::Array::New(this->env, this->batch.bytesRead.size());
+            for (size_t i = 0; i < this->batch.bytesRead.size(); i++)
+               rs.Set((uint32_t)i, Napi::Number::New(this->env, (double)this->batch.bytesRead[i]));
+            this->deferred.Resolve(rs);
+         }
+      }
+
+      static void OnClose(uv_handle_t *handle) {
+         delete (AsyncState *)handle->data;
+      }
+      static void OnDone(uv_async_t *handle) {
+         ((AsyncState *)handle->data)->Settle();
+         uv_close((uv_handle_t *)handle, OnClose);
+      }
+   };
+
+   Napi::Promise ReadAsync(
+      Napi::Env env, uv_file fd, std::vector<Extent> extents,
+      std::vector<Napi::Reference<Napi::Buffer<char>>> keepAlive, std::function<void()> onSettled) {
+      uv_loop_t *loop = NULL;
+      if (napi_get_uv_event_loop(env, &loop) != napi_ok || loop == NULL)
+         throw NodeException(NodeError::Generic, "Cannot get the event loop of the current environment.");
+      auto *state = new AsyncState(env, fd, std::move(extents), std::move(keepAlive), onSettled);
+      auto promise = state->deferred.Promise();
+      if (state->batch.extents.empty()) {
+         state->Settle();
+         delete state;
+         return promise;
+      }
+      // the handle also keeps the loop alive until the batch is done
+      auto rs = uv_async_init(loop, &state->async, AsyncState::OnDone);
+      if (rs < 0) {
+         delete state;
+         THROW_UV(rs, "");
+      }
+      state->async.data = state;
+      try {
+         Submit(&state->batch);
+      } catch (...) {
+         uv_close((uv_handle_t *)&state->async, AsyncState::OnClose);
+         throw;
+      }
+      return promise;
+   }
+
+   // setReadManyQueueDepth(depth: number): void
+   static void SetReadManyQueueDepth(const Napi::CallbackInfo &info) {
+      auto env = info.Env();
+      HandleException(env, [&]() {
+         auto inputError = IsSafeInteger(info[0], sizeof(size_t), true);
+         if (inputError == IntegerInvalid::Type) // depth
+            throw NodeException(NodeError::Type, GetSafeIntegerMessage(sizeof(size_t), "first argument", true));
+         else if (inputError == IntegerInvalid::Range) // depth
+            throw NodeException(NodeError::Range, GetSafeIntegerMessage(sizeof(size_t), "first argument", true));
+
+         auto depth = (size_t)info[0].As<Napi::Number>().DoubleValue();
+         if (depth == 0 || depth > MAX_QUEUE_DEPTH)
+            throw NodeException(NodeError::Range, "depth must be between 1 and " + std::to_string(MAX_QUEUE_DEPTH) + ".");
+         SetQueueDepth(depth);
+      });
+   }
+
+   void Prepare(Napi::Env env, Napi::Object exports) {
+      exports.Set("SetReadManyQueueDepth", Napi::Function::New(env, SetReadManyQueueDepth, "setReadManyQueueDepth"));
+   }
+}
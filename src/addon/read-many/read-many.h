@@ -0,0 +1,38 @@
+#ifndef READ_MANY_H
+#define READ_MANY_H
+
+#include <napi.h>
+#include <uv.h>
+#include <cstdint>
+#include <vector>
+#include <functional>
+// Batched positional reads, served by a pool of threads dedicated to them, so that they neither wait for
+// nor hold up the libuv threadpool (fs, dns, zlib, crypto), and the sync version doesn't need an event loop.
+namespace ReadMany {
+   void Prepare(Napi::Env env, Napi::Object exports);
+
+   // The number of threads of the pool, which is the number of reads in flight at once.
+   const size_t DEFAULT_QUEUE_DEPTH = 16;
+   const size_t MAX_QUEUE_DEPTH = 1024;
+
+   // One positional read: length bytes at offset of the file, stored into data.
+   struct Extent {
+      int64_t offset;
+      char *data;
+      size_t length;
+   };
+
+   // Grows or shrinks the pool, threads are started on demand and the extra ones exit once they finish their current read.
+   void SetQueueDepth(size_t depth);
+
+   // Reads all extents and blocks until they are done.
+   std::vector<size_t> ReadSync(uv_file fd, std::vector<Extent> extents);
+
+   // Reads all extents in the background, the promise resolves with the number of bytes read for each extent.
+   // keepAlive holds the target buffers until the reads are done, onSettled is called right before the promise settles.
+   Napi::Promise ReadAsync(
+      Napi::Env env, uv_file fd, std::vector<Extent> extents,
+      std::vector<Napi::Reference<Napi::Buffer<char>>> keepAlive, std::function<void()> onSettled);
+}
+
+#endif // !READ_MANY_H
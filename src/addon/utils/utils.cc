@@ -225,3 +225,23 @@ void SetFileBufSize(FILE *file, char *buffer, int mode, size_t size) {
    if (setvbuf(file, buffer, mode, size) != 0)
       THROW_ERRNO;
 }
+
+size_t ReadFileAt(int fd, void *ptr, size_t count, int64_t offset) {
+   size_t nRead = 0;
+   while (nRead < count) {
+      // uv_buf_t can't describe more than 4GiB on every platform
+      auto remaining = count - nRead;
+      auto chunk = remaining < (size_t)INT32_MAX ? remaining : (size_t)INT32_MAX;
+      auto buf = uv_buf_init((char *)ptr + nRead, (unsigned int)chunk);
+      uv_fs_t req;
+      // a synchronous request doesn't use the loop, and libuv keeps the position of fd on every platform
+      auto rs = uv_fs_read(uv_default_loop(), &req, fd, &buf, 1, offset + (int64_t)nRead, NULL);
+      uv_fs_req_cleanup(&req);
+      if (rs < 0)
+         THROW_UV(rs, "");
+      if (rs == 0)
+         break;
+      nRead += (size_t)rs;
+   }
+   return nRead;
+}
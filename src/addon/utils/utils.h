@@ -3,6 +3,7 @@
 
 #include <v8.h>
 #include <cstdio>
+#include <cstdint>
 #include <sstream>
 #include "../exception-handler/exception-handler.h"
 
@@ -61,6 +62,11 @@ FILE *CreateFileFromFd(int fd);
    { errno = errCode; \
    throw NodeException(NodeError::Errno, message, __func__, CURRENT_PATH); }
 
+#define THROW_UV(uvCode, message) \
+   { NodeException uvException(NodeError::Uv, message, __func__, CURRENT_PATH); \
+   uvException.code = uvCode; \
+   throw uvException; }
+
 #define THROW_IF_NOT_SAFE_NUMBER(x) \
    if (x > MAX_SAFE_INTEGER || x < MIN_SAFE_INTEGER) \
       THROW_ERRNO_EX(EOVERFLOW, "")
@@ -91,4 +97,7 @@ void WriteFile(FILE *file, const void *ptr, size_t size, size_t count);
 void FlushFile(FILE *file);
 
 void SetFileBufSize(FILE *file, char *buffer, int mode, size_t size);
+
+// Reads up to count bytes at offset without moving the position of fd, returns 0 at EOF.
+size_t ReadFileAt(int fd, void *ptr, size_t count, int64_t offset);
 #endif
\ No newline at end of file
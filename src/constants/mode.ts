@@ -17,3 +17,11 @@ export enum SeekOrigin {
   /** Specifies the end of a file. */
   End = SEEK_END,
 }
+
+/** Specifies the order in which bits are taken from (or put into) each byte. */
+export enum BitOrder {
+  /** The most significant bit of a byte comes first, as in JPEG or MPEG bitstreams. */
+  MsbFirst = 0,
+  /** The least significant bit of a byte comes first, as in DEFLATE bitstreams. */
+  LsbFirst = 1,
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+import assert from 'assert';
+import { CSCode } from '../src/constants/error';
+import { openTruncated, installHookToFile, removeHookFromFile, openTruncatedToRead, openToReadWithContent, getFileContent } from './utils';
+import { BitReader, BitWriter } from '../src/addon/bits';
+import { BitOrder, SeekOrigin } from '../src/constants/mode';
+import { INativeFile } from '../src/addon/file';
+
+describe('BitReader and BitWriter Tests', () => {
+  const fileArr: INativeFile[] = [];
+  before(() => {
+    installHookToFile(fileArr);
+  });
+  afterEach(() => {
+    fileArr.forEach(e => e.close());
+    fileArr.length = 0;
+  });
+  after(() => {
+    removeHookFromFile();
+  });
+
+  it('Read MSB-first', () => {
+    const reader = new BitReader(openToReadWithContent(Buffer.from([0b10110010, 0b01111111, 0xAB])));
+    assert.strictEqual(reader.order, BitOrder.MsbFirst);
+    assert.strictEqual(reader.peek(3), 0b101);
+    assert.strictEqual(reader.read(3), 0b101);
+    assert.strictEqual(reader.read(6), 0b100100);
+    reader.skip(2);
+    reader.alignToByte();
+    assert.strictEqual(reader.read(8), 0xAB);
+    assert.strictEqual(reader.peek(8), 0);
+    assert.throws(() => reader.read(1), { code: CSCode.ReadBeyondEndOfFile });
+  });
+
+  it('Read LSB-first', () => {
+    const reader = new BitReader(openToReadWithContent(Buffer.from([0b10110010, 0b01111111])), BitOrder.LsbFirst);
+    assert.strictEqual(reader.read(3), 0b010);
+    assert.strictEqual(reader.read(6), 0b110110);
+    assert.strictEqual(reader.read(7), 0b0111111);
+  });
+
+  it('Read wide fields', () => {
+    const bytes = Buffer.from([0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00]);
+    const reader = new BitReader(openToReadWithContent(bytes));
+    assert.strictEqual(reader.read(53), Number.MAX_SAFE_INTEGER);
+    assert.strictEqual(reader.read(11), 0x7FF);
+    assert.strictEqual(reader.read(8), 0);
+  });
+
+  it('Skip', () => {
+    const content = Buffer.alloc(100000);
+    for (let i = 0; i < content.length; i++)
+      content[i] = i & 0xFF;
+    const reader = new BitReader(openToReadWithContent(content));
+    assert.strictEqual(reader.read(4), 0);
+    reader.skip(4 + 8 * 50000);
+    assert.strictEqual(reader.read(8), 50001 & 0xFF);
+    reader.skip(3);
+    assert.strictEqual(reader.read(5), 50002 & 0x1F);
+
+    // a failed skip doesn't consume anything
+    assert.throws(() => reader.skip(8 * 50000), { code: CSCode.ReadBeyondEndOfFile });
+    assert.strictEqual(reader.read(8), 50003 & 0xFF);
+    reader.skip(8 * (content.length - 50004));
+    assert.throws(() => reader.read(1), { code: CSCode.ReadBeyondEndOfFile });
+  });
+
+  it('Unpack', () => {
+    const reader = new BitReader(openToReadWithContent(Buffer.from([0x12, 0x34, 0x56])));
+    const arr = new Uint16Array(8);
+    assert.strictEqual(reader.unpack(arr, 4, 1), 6);
+    assert.deepStrictEqual(Array.from(arr), [0, 1, 2, 3, 4, 5, 6, 0]);
+  });
+
+  it('Sync', () => {
+    const file = openToReadWithContent(Buffer.from([1, 2, 3, 4]));
+    const reader = new BitReader(file);
+    assert.strictEqual(reader.read(4), 0);
+    reader.sync();
+    assert.strictEqual(file.tell(), 1);
+    file.seek(1, SeekOrigin.Current);
+    assert.strictEqual(reader.read(8), 3);
+  });
+
+  it('Write and read back', () => {
+    for (const order of [BitOrder.MsbFirst, BitOrder.LsbFirst]) {
+      const file = openTruncated();
+      const writer = new BitWriter(file, order);
+      writer.write(1, 1);
+      writer.write(0x1234, 13);
+      writer.write(Number.MAX_SAFE_INTEGER, 53);
+      writer.pack(new Int8Array([-1, 2, 3]), 5);
+      writer.alignToByte();
+      writer.flush();
+
+      file.seek(0, SeekOrigin.Begin);
+      const reader = new BitReader(file, order);
+      assert.strictEqual(reader.read(1), 1);
+      assert.strictEqual(reader.read(13), 0x1234);
+      assert.strictEqual(reader.read(53), Number.MAX_SAFE_INTEGER);
+      const arr = new Uint8Array(3);
+      assert.strictEqual(reader.unpack(arr, 5), 3);
+      assert.deepStrictEqual(Array.from(arr), [31, 2, 3]);
+      assert.strictEqual(getFileContent(file).length, 11);
+    }
+  });
+
+  it('MSB-first write layout', () => {
+    const file = openTruncated();
+    const writer = new BitWriter(file);
+    writer.write(0b101, 3);
+    writer.write(0b11, 2);
+    writer.alignToByte();
+    writer.flush();
+    assert.ok(getFileContent(file).equals(Buffer.from([0b10111000])));
+  });
+
+  it('Ctor | Negative', () => {
+    assert.throws(() => new BitReader(null), TypeError);
+    assert.throws(() => new BitReader({} as never), TypeError);
+    assert.throws(() => new BitReader(openTruncatedToRead(), 'x' as never), TypeError);
+    assert.throws(() => new BitReader(openTruncatedToRead(), 2), RangeError);
+    assert.throws(() => new BitWriter(openTruncatedToRead()), { code: CSCode.FileNotWritable });
+
+    const file = openTruncated();
+    file.close();
+    assert.throws(() => new BitReader(file), { code: CSCode.FileNotReadable });
+  });
+
+  it('Arguments | Negative', () => {
+    const reader = new BitReader(openToReadWithContent(Buffer.alloc(16)));
+    assert.throws(() => reader.read(null), TypeError);
+    assert.throws(() => reader.read(1.5), TypeError);
+    assert.throws(() => reader.read(0), RangeError);
+    assert.throws(() => reader.peek(54), RangeError);
+    assert.throws(() => reader.skip(-1), RangeError);
+    assert.throws(() => reader.unpack(new Float64Array(1) as never, 1), TypeError);
+    assert.throws(() => reader.unpack(new Uint8Array(1), 9), RangeError);
+    assert.throws(() => reader.unpack(new Uint8Array(1), 8, 2), RangeError);
+    assert.throws(() => reader.unpack(new Uint8Array(1), 8, 0, 2), RangeError);
+    assert.throws(() => reader.skip(129), { code: CSCode.ReadBeyondEndOfFile });
+
+    const writer = new BitWriter(openTruncated());
+    assert.throws(() => writer.write(4, 2), RangeError);
+    assert.throws(() => writer.write(-1, 2), RangeError);
+    assert.throws(() => writer.write(0.5, 2), TypeError);
+    assert.throws(() => writer.write(0, 54), RangeError);
+  });
+});
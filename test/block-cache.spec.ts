@@ -0,0 +1,189 @@
+import assert from 'assert';
+import fs from 'fs';
+import { installHookToFile, removeHookFromFile, openToReadWithContent, TmpFilePath, getFileContent } from './utils';
+import { setBlockCache, cacheStats } from '../src/addon/block-cache';
+import { SeekOrigin } from '../src/constants/mode';
+import { IFile } from '../src/addon/file';
+import { BinaryReader } from '../src/binary-reader';
+
+describe('Block Cache Tests', () => {
+  const fileArr: IFile[] = [];
+  let File: new (fd: number) => IFile;
+  before(() => {
+    File = installHookToFile(fileArr);
+  });
+  beforeEach(() => {
+    setBlockCache(2048, 512);
+  });
+  afterEach(() => {
+    fileArr.forEach(e => e.close());
+    fileArr.length = 0;
+    setBlockCache(0);
+  });
+  after(() => {
+    removeHookFromFile();
+  });
+
+  it('Shares blocks between files', () => {
+    const content = Buffer.from('0123456789abcdefghijklmnopqrstuvwxyz');
+    const file1 = openToReadWithContent(content);
+    const file2 = new File(fs.openSync(TmpFilePath, 'r'));
+
+    const buf = Buffer.alloc(4);
+    file1.seek(3, SeekOrigin.Begin);
+    assert.strictEqual(file1.read(buf), 4);
+    assert.ok(buf.equals(Buffer.from('3456')));
+    assert.strictEqual(file1.tell(), 7);
+    assert.strictEqual(cacheStats().misses, 1);
+
+    file2.seek(12, SeekOrigin.Begin);
+    assert.strictEqual(file2.read(buf), 4);
+    assert.ok(buf.equals(Buffer.from('cdef')));
+    const stats = cacheStats();
+    assert.strictEqual(stats.hits, 1);
+    assert.strictEqual(stats.blocks, 1);
+    assert.strictEqual(stats.capacity, 4);
+    assert.strictEqual(stats.blockSize, 512);
+  });
+
+  it('Reads match the file', () => {
+    const content = Buffer.from(Array.from({ length: 5000 }, (_, i) => i & 0xFF));
+    const file = openToReadWithContent(content);
+    const reader = new BinaryReader(file);
+    assert.strictEqual(reader.readByte(), 0);
+    assert.ok(reader.readBytes(30).equals(content.subarray(1, 31)));
+    file.seek(-2, SeekOrigin.Current);
+    assert.strictEqual(reader.readByte(), 29);
+    file.seek(-1, SeekOrigin.End);
+    assert.strictEqual(reader.readByte(), 4999 & 0xFF);
+    assert.strictEqual(file.read(Buffer.alloc(1)), 0);
+    assert.ok(getFileContent(file).equals(content));
+    file.seek(0, SeekOrigin.Begin);
+    for (let i = 0; i < content.length; i++)
+      assert.strictEqual(reader.readByte(), i & 0xFF);
+    assert.ok(cacheStats().evictions > 0);
+    assert.ok(cacheStats().bytes <= 2048);
+  });
+
+  it('Caches bulk reads unless they are large', () => {
+    setBlockCache(8 * 512, 512);
+    const content = Buffer.from(Array.from({ length: 4096 }, (_, i) => i & 0xFF));
+    const file = openToReadWithContent(content);
+    const buf = Buffer.alloc(3 * 512);
+    assert.strictEqual(file.read(buf.subarray(0, 1024)), 1024);
+    assert.strictEqual(cacheStats().blocks, 2);
+    file.seek(600, SeekOrigin.Begin);
+    assert.strictEqual(file.read(buf.subarray(0, 1)), 1);
+    assert.strictEqual(buf[0], 600 & 0xFF);
+    assert.strictEqual(cacheStats().hits, 1);
+
+    // three blocks are more than a quarter of the cache
+    file.seek(1024, SeekOrigin.Begin);
+    assert.strictEqual(file.read(buf), buf.length);
+    assert.ok(buf.equals(content.subarray(1024, 1024 + buf.length)));
+    assert.strictEqual(cacheStats().blocks, 2);
+  });
+
+  it('Reads at end of file cache nothing', () => {
+    const file = openToReadWithContent(Buffer.from('0123456789'));
+    file.seek(0, SeekOrigin.End);
+    assert.strictEqual(file.read(Buffer.alloc(4)), 0);
+    file.seek(1024, SeekOrigin.Begin);
+    assert.strictEqual(file.read(Buffer.alloc(4)), 0);
+    assert.strictEqual(cacheStats().blocks, 0);
+  });
+
+  it('Writes invalidate cached blocks', () => {
+    const reader = openToReadWithContent(Buffer.from('Hello World'));
+    const writer = new File(fs.openSync(TmpFilePath, 'r+'));
+    const buf = Buffer.alloc(5);
+    assert.strictEqual(reader.read(buf), 5);
+
+    writer.seek(6, SeekOrigin.Begin);
+    writer.write(Buffer.from('There'));
+    writer.flush();
+    assert.ok(cacheStats().invalidations > 0);
+
+    reader.seek(6, SeekOrigin.Begin);
+    assert.strictEqual(reader.read(buf), 5);
+    assert.ok(buf.equals(Buffer.from('There')));
+  });
+
+  it('Files opened after the content is replaced see the new content', () => {
+    const buf = Buffer.alloc(16);
+    const reader1 = openToReadWithContent(Buffer.from('Hello World'));
+    assert.strictEqual(reader1.read(buf), 11);
+    reader1.close();
+    assert.strictEqual(cacheStats().blocks, 1);
+
+    // truncated and rewritten in place, same inode
+    fs.writeFileSync(TmpFilePath, 'Bye');
+    const reader2 = new File(fs.openSync(TmpFilePath, 'r'));
+    assert.strictEqual(reader2.read(buf), 3);
+    assert.ok(buf.subarray(0, 3).equals(Buffer.from('Bye')));
+    reader2.close();
+
+    // deleted and created again, the inode may be reused
+    fs.unlinkSync(TmpFilePath);
+    fs.writeFileSync(TmpFilePath, 'Hello Again');
+    const reader3 = new File(fs.openSync(TmpFilePath, 'r'));
+    assert.strictEqual(reader3.read(buf), 11);
+    assert.ok(buf.subarray(0, 11).equals(Buffer.from('Hello Again')));
+  });
+
+  it('A file reads its own writes', () => {
+    fs.writeFileSync(TmpFilePath, 'abcdef');
+    const file = new File(fs.openSync(TmpFilePath, 'r+'));
+    const buf = Buffer.alloc(2);
+    assert.strictEqual(file.read(buf), 2);
+    file.write(Buffer.from('XY'));
+    assert.strictEqual(file.tell(), 4);
+    file.seek(0, SeekOrigin.Begin);
+    const all = Buffer.alloc(6);
+    assert.strictEqual(file.read(all), 6);
+    assert.ok(all.equals(Buffer.from('abXYef')));
+  });
+
+  it('Seeking a written file invalidates cached blocks', () => {
+    fs.writeFileSync(TmpFilePath, 'Hello World');
+    const writer = new File(fs.openSync(TmpFilePath, 'r+'));
+    const reader = new File(fs.openSync(TmpFilePath, 'r'));
+    const buf = Buffer.alloc(5);
+
+    // the write stays in the stdio buffer of writer, so reader caches the old content
+    writer.write(Buffer.from('Jello'));
+    assert.strictEqual(reader.read(buf), 5);
+    assert.ok(buf.equals(Buffer.from('Hello')));
+
+    // seeking writes the pending output out
+    writer.seek(0, SeekOrigin.Begin);
+    reader.seek(0, SeekOrigin.Begin);
+    assert.strictEqual(reader.read(buf), 5);
+    assert.ok(buf.equals(Buffer.from('Jello')));
+  });
+
+  it('Disabling file buffering stops using the cache', () => {
+    const file = openToReadWithContent(Buffer.from('0123456789'));
+    const buf = Buffer.alloc(3);
+    assert.strictEqual(file.read(buf), 3);
+    file.setBufSize(0);
+    assert.strictEqual(file.read(buf), 3);
+    assert.ok(buf.equals(Buffer.from('345')));
+    // the file descriptor has moved along with the reads
+    assert.strictEqual(fs.readSync(file.fd, buf, 0, 3, null), 3);
+    assert.ok(buf.equals(Buffer.from('678')));
+    const misses = cacheStats().misses;
+    file.seek(0, SeekOrigin.Begin);
+    file.read(buf);
+    assert.strictEqual(cacheStats().misses, misses);
+  });
+
+  it('Set block cache | Negative', () => {
+    assert.throws(() => setBlockCache(null), TypeError);
+    assert.throws(() => setBlockCache(-1), RangeError);
+    assert.throws(() => setBlockCache(1024, 0), RangeError);
+    assert.throws(() => setBlockCache(1 << 30, 1), RangeError);
+    assert.throws(() => setBlockCache(1024, 511), RangeError);
+    assert.throws(() => setBlockCache(1024, 1.5), TypeError);
+  });
+});
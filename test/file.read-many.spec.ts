@@ -0,0 +1,121 @@
+import assert from 'assert';
+import fs from 'fs';
+import { openTruncated, installHookToFile, removeHookFromFile, openToReadWithContent, TmpFilePath, getRandomInt } from './utils';
+import { INativeFile, ReadExtent, setReadManyQueueDepth } from '../src/addon/file';
+
+describe('File | ReadMany Tests', () => {
+  const fileArr: INativeFile[] = [];
+  let File: new (fd: number) => INativeFile;
+  before(() => {
+    File = installHookToFile(fileArr);
+  });
+  afterEach(() => {
+    fileArr.forEach(e => e.close());
+    fileArr.length = 0;
+  });
+  after(() => {
+    removeHookFromFile();
+  });
+
+  it('Read extents', async () => {
+    const file = openToReadWithContent(Buffer.from('Hello World'));
+    const a = Buffer.alloc(5), b = Buffer.alloc(5), c = Buffer.alloc(0);
+    const extents = [
+      { offset: 6, target: a },
+      { offset: 0, length: 3, target: b },
+      { offset: 0, target: c },
+    ];
+    assert.deepStrictEqual(file.readMany(extents), [5, 3, 0]);
+    assert.ok(a.equals(Buffer.from('World')));
+    assert.ok(b.subarray(0, 3).equals(Buffer.from('Hel')));
+    assert.strictEqual(file.tell(), 0);
+
+    a.fill(0);
+    assert.deepStrictEqual(await file.readManyAsync(extents), [5, 3, 0]);
+    assert.ok(a.equals(Buffer.from('World')));
+    assert.deepStrictEqual(file.readMany([]), []);
+    assert.deepStrictEqual(await file.readManyAsync([]), []);
+  });
+
+  it('Resubmit a short read until end-of-file', async () => {
+    // the first read of an extent crossing the end of file is short, the resubmitted one returns 0
+    const file = openToReadWithContent(Buffer.from('0123456789'));
+    const target = Buffer.alloc(8);
+    assert.deepStrictEqual(file.readMany([{ offset: 6, target }]), [4]);
+    assert.ok(target.subarray(0, 4).equals(Buffer.from('6789')));
+    target.fill(0);
+    assert.deepStrictEqual(await file.readManyAsync([{ offset: 6, target }, { offset: 20, target: Buffer.alloc(2) }]), [4, 0]);
+    assert.ok(target.subarray(0, 4).equals(Buffer.from('6789')));
+  });
+
+  it('Large out-of-order batch', async () => {
+    const content = Buffer.alloc(1 << 20);
+    for (let i = 0; i < content.length; i += 4)
+      content.writeUInt32LE(i, i);
+    const file = openToReadWithContent(content);
+
+    const extents: ReadExtent[] = [];
+    for (let i = 0; i < 2000; i++) {
+      const offset = getRandomInt(0, content.length);
+      extents.push({ offset, target: Buffer.alloc(getRandomInt(1, 4096)) });
+    }
+    const check = (bytesRead: number[]) => {
+      extents.forEach((extent, i) => {
+        const expected = content.subarray(extent.offset, extent.offset + extent.target.length);
+        assert.strictEqual(bytesRead[i], expected.length);
+        assert.ok(extent.target.subarray(0, expected.length).equals(expected));
+      });
+    };
+    check(file.readMany(extents));
+    extents.forEach(e => e.target.fill(0));
+    check(await file.readManyAsync(extents));
+  });
+
+  it('Queue depth', async () => {
+    const content = Buffer.from(Array.from({ length: 4096 }, (_, i) => i & 0xFF));
+    const file = openToReadWithContent(content);
+    const extents = Array.from({ length: 64 }, (_, i) => ({ offset: i * 64, target: Buffer.alloc(64) }));
+    const check = (bytesRead: number[]) => {
+      assert.ok(bytesRead.every(n => n === 64));
+      extents.forEach(e => assert.ok(e.target.equals(content.subarray(e.offset, e.offset + 64))));
+    };
+    try {
+      for (const depth of [1, 64, 2]) {
+        setReadManyQueueDepth(depth);
+        extents.forEach(e => e.target.fill(0));
+        check(file.readMany(extents));
+        extents.forEach(e => e.target.fill(0));
+        check(await file.readManyAsync(extents));
+      }
+    } finally {
+      setReadManyQueueDepth(16);
+    }
+
+    assert.throws(() => setReadManyQueueDepth(null), TypeError);
+    assert.throws(() => setReadManyQueueDepth(1.5), TypeError);
+    assert.throws(() => setReadManyQueueDepth(0), RangeError);
+    assert.throws(() => setReadManyQueueDepth(1025), RangeError);
+  });
+
+  it('See buffered writes', () => {
+    const file = openTruncated();
+    file.write(Buffer.from('abc'));
+    const target = Buffer.alloc(3);
+    assert.deepStrictEqual(file.readMany([{ offset: 0, target }]), [3]);
+    assert.ok(target.equals(Buffer.from('abc')));
+  });
+
+  it('Errors', async () => {
+    const file = openToReadWithContent(Buffer.alloc(10));
+    const pending = file.readManyAsync([{ offset: 0, target: Buffer.alloc(10) }]);
+    assert.throws(() => file.close(), { code: 'EBUSY' });
+    await pending;
+
+    const writeOnly = new File(fs.openSync(TmpFilePath, 'w'));
+    assert.throws(() => writeOnly.readMany([{ offset: 0, target: Buffer.alloc(1) }]), { code: 'EBADF' });
+    await assert.rejects(writeOnly.readManyAsync([{ offset: 0, target: Buffer.alloc(1) }]), { code: 'EBADF' });
+
+    file.close();
+    assert.throws(() => file.readMany([]), { code: 'EBADF' });
+  });
+});
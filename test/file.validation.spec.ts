@@ -3,11 +3,11 @@ import fs from 'fs';
 import { openTruncated, installHookToFile, removeHookFromFile, openToReadWithContent, openWithContent, TmpFilePath } from './utils';
 import { SeekOrigin } from '../src/constants/mode';
 import { openNullDevice } from '../src/utils/file';
-import { IFile } from '../src/addon/file';
+import { INativeFile } from '../src/addon/file';
 
 describe('File | Arguments Validation Test', () => {
-  const fileArr: IFile[] = [];
-  let File: new (fd: number) => IFile;
+  const fileArr: INativeFile[] = [];
+  let File: new (fd: number) => INativeFile;
   before(() => {
     File = installHookToFile(fileArr);
   });
@@ -141,6 +141,31 @@ describe('File | Arguments Validation Test', () => {
     assert.throws(() => file.setBufSize(-1), RangeError);
   });
 
+  it('ReadMany | Negative', () => {
+    const file = openToReadWithContent(Buffer.alloc(10));
+    assert.throws(() => file.readMany(null), TypeError);
+    assert.throws(() => file.readMany([null]), TypeError);
+    assert.throws(() => file.readMany([{ offset: 0, target: null }]), TypeError);
+    assert.throws(() => file.readMany([{ offset: '0' as never, target: Buffer.alloc(1) }]), TypeError);
+    assert.throws(() => file.readMany([{ offset: 0.5, target: Buffer.alloc(1) }]), TypeError);
+    assert.throws(() => file.readMany([{ offset: 0, length: 9.9, target: Buffer.alloc(1) }]), TypeError);
+
+    assert.throws(() => file.readMany([{ offset: -1, target: Buffer.alloc(1) }]), RangeError);
+    assert.throws(() => file.readMany([{ offset: 0, length: -1, target: Buffer.alloc(1) }]), RangeError);
+    assert.throws(() => file.readMany([{ offset: 0, length: 2, target: Buffer.alloc(1) }]), RangeError);
+  });
+
+  it('ReadManyAsync | Negative', async () => {
+    const file = openToReadWithContent(Buffer.alloc(10));
+    await assert.rejects(file.readManyAsync(null), TypeError);
+    await assert.rejects(file.readManyAsync([{ offset: 0.5, target: Buffer.alloc(1) }]), TypeError);
+    await assert.rejects(file.readManyAsync([{ offset: -1, target: Buffer.alloc(1) }]), RangeError);
+    await assert.rejects(file.readManyAsync([{ offset: 0, length: 2, target: Buffer.alloc(1) }]), RangeError);
+
+    file.close();
+    await assert.rejects(file.readManyAsync([]), { code: 'EBADF' });
+  });
+
   it('File mode', () => {
     let fd = fs.openSync(TmpFilePath, 'w+');
     let file = new File(fd);
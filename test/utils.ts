@@ -1,5 +1,5 @@
 import fse from 'fs-extra';
-import { IFile, NativeFile as _File } from '../src/addon/file';
+import { IFile, INativeFile, NativeFile as _File } from '../src/addon/file';
 import fs from 'fs';
 import { SeekOrigin } from '../src/constants/mode';
 import path from 'path';
@@ -25,24 +25,24 @@ export function removeHookFromFile(): void {
   File = OriginalFile;
 }
 
-export function openTruncated(): IFile {
+export function openTruncated(): INativeFile {
   const fd = fs.openSync(TmpFilePath, 'w+');
   return new File(fd);
 }
 
-export function openTruncatedToRead(): IFile {
+export function openTruncatedToRead(): INativeFile {
   fs.writeFileSync(TmpFilePath, '', { flag: 'w' });
   const fd = fs.openSync(TmpFilePath, 'r');
   return new File(fd);
 }
 
-export function openWithContent(content: Buffer): IFile {
+export function openWithContent(content: Buffer): INativeFile {
   fs.writeFileSync(TmpFilePath, content, { flag: 'w' });
   const fd = fs.openSync(TmpFilePath, 'w+');
   return new File(fd);
 }
 
-export function openToReadWithContent(content: Buffer): IFile {
+export function openToReadWithContent(content: Buffer): INativeFile {
   fs.writeFileSync(TmpFilePath, content, { flag: 'w' });
   const fd = fs.openSync(TmpFilePath, 'r');
   return new File(fd);